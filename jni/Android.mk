@@ -5,7 +5,7 @@ LOCAL_MODULE := encored
 
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/include
 
-LOCAL_STATIC_LIBRARIES := rapidjson spdlog InotifyWatcher GameRegistry EncoreUtility DeviceInfo BinderNDK BinderMonitor
+LOCAL_STATIC_LIBRARIES := rapidjson spdlog InotifyWatcher GameRegistry EncoreUtility DeviceInfo BinderNDK BinderMonitor ProfileEngine
 
 LOCAL_SRC_FILES := $(wildcard $(LOCAL_PATH)/*.cpp)
 LOCAL_SRC_FILES := $(LOCAL_SRC_FILES:$(LOCAL_PATH)/%=%)
@@ -17,4 +17,11 @@ LOCAL_LDFLAGS += -flto
 
 include $(BUILD_EXECUTABLE)
 
-include $(LOCAL_PATH)/external/Android.mk $(LOCAL_PATH)/base/Android.mk
+ENCORE_JNI_PATH := $(LOCAL_PATH)
+
+include $(ENCORE_JNI_PATH)/external/Android.mk $(ENCORE_JNI_PATH)/base/Android.mk
+
+# Profile transition benchmark, build with: ndk-build ENCORE_BENCH=1
+ifeq ($(ENCORE_BENCH),1)
+include $(ENCORE_JNI_PATH)/bench/Android.mk
+endif
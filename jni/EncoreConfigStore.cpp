@@ -76,6 +76,7 @@ bool EncoreConfigStore::save_config(const std::string &config_path) {
     prefs_obj.AddMember("enforce_lite_mode", config_.preferences.enforce_lite_mode, allocator);
     prefs_obj.AddMember("use_device_mitigation", config_.preferences.use_device_mitigation, allocator);
     prefs_obj.AddMember("disable_tweaks", config_.preferences.disable_tweaks, allocator);
+    prefs_obj.AddMember("auto_detect_games", config_.preferences.auto_detect_games, allocator);
     prefs_obj.AddMember("log_level", config_.preferences.log_level, allocator);
     doc.AddMember("preferences", prefs_obj, allocator);
 
@@ -85,6 +86,13 @@ bool EncoreConfigStore::save_config(const std::string &config_path) {
     cpu_gov_obj.AddMember("powersave", rapidjson::Value(config_.cpu_governor.powersave.c_str(), allocator).Move(), allocator);
     doc.AddMember("cpu_governor", cpu_gov_obj, allocator);
 
+    // Serialize profile transition
+    rapidjson::Value transition_obj(rapidjson::kObjectType);
+    transition_obj.AddMember("debounce_ms", config_.transition.debounce_ms, allocator);
+    transition_obj.AddMember("screen_off_hold_ms", config_.transition.screen_off_hold_ms, allocator);
+    transition_obj.AddMember("max_latency_ms", config_.transition.max_latency_ms, allocator);
+    doc.AddMember("transition", transition_obj, allocator);
+
     rapidjson::StringBuffer buffer;
     rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
     writer.SetIndent(' ', 2);
@@ -118,6 +126,11 @@ EncoreConfigStore::CPUGovernor EncoreConfigStore::get_cpu_governor() const {
     return config_.cpu_governor;
 }
 
+EncoreConfigStore::Transition EncoreConfigStore::get_transition() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_.transition;
+}
+
 void EncoreConfigStore::set_preferences(const Preferences &prefs) {
     std::lock_guard<std::mutex> lock(mutex_);
     config_.preferences = prefs;
@@ -165,11 +178,17 @@ bool EncoreConfigStore::create_default_config() {
             .enforce_lite_mode = false,
             .use_device_mitigation = false,
             .disable_tweaks = false,
+            .auto_detect_games = false,
             .log_level = 4
         },
         .cpu_governor = {
             .balance = default_governor,
             .powersave = default_governor
+        },
+        .transition = {
+            .debounce_ms = 250,
+            .screen_off_hold_ms = 5000,
+            .max_latency_ms = 1000
         }
     };
     // clang-format on
@@ -201,6 +220,10 @@ bool EncoreConfigStore::parse_config(const rapidjson::Document &doc) {
             new_config.preferences.disable_tweaks = prefs["disable_tweaks"].GetBool();
         }
 
+        if (prefs.HasMember("auto_detect_games") && prefs["auto_detect_games"].IsBool()) {
+            new_config.preferences.auto_detect_games = prefs["auto_detect_games"].GetBool();
+        }
+
         if (prefs.HasMember("log_level") && prefs["log_level"].IsInt()) {
             new_config.preferences.log_level = prefs["log_level"].GetInt();
         }
@@ -219,6 +242,23 @@ bool EncoreConfigStore::parse_config(const rapidjson::Document &doc) {
         }
     }
 
+    // Parse profile transition, negative durations are rejected
+    if (doc.HasMember("transition") && doc["transition"].IsObject()) {
+        const rapidjson::Value &transition = doc["transition"];
+
+        if (transition.HasMember("debounce_ms") && transition["debounce_ms"].IsInt()) {
+            new_config.transition.debounce_ms = std::max(0, transition["debounce_ms"].GetInt());
+        }
+
+        if (transition.HasMember("screen_off_hold_ms") && transition["screen_off_hold_ms"].IsInt()) {
+            new_config.transition.screen_off_hold_ms = std::max(0, transition["screen_off_hold_ms"].GetInt());
+        }
+
+        if (transition.HasMember("max_latency_ms") && transition["max_latency_ms"].IsInt()) {
+            new_config.transition.max_latency_ms = std::max(0, transition["max_latency_ms"].GetInt());
+        }
+    }
+
     {
         std::lock_guard<std::mutex> lock(mutex_);
         config_ = new_config;
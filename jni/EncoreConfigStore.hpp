@@ -33,6 +33,7 @@ public:
         bool enforce_lite_mode = false;
         bool use_device_mitigation = false;
         bool disable_tweaks = false;
+        bool auto_detect_games = false;
         int log_level = 4;
     };
 
@@ -41,9 +42,16 @@ public:
         std::string powersave;
     };
 
+    struct Transition {
+        int debounce_ms = 250;         /// Quiet period before a burst of events is acted upon
+        int screen_off_hold_ms = 5000; /// Time a running game keeps performance after screen off
+        int max_latency_ms = 1000;     /// Longest a burst may postpone the evaluation of its first event
+    };
+
     struct ConfigData {
         Preferences preferences;
         CPUGovernor cpu_governor;
+        Transition transition;
     };
 
     /**
@@ -83,6 +91,11 @@ public:
      */
     CPUGovernor get_cpu_governor() const;
 
+    /**
+     * @brief Get profile transition settings
+     */
+    Transition get_transition() const;
+
     /**
      * @brief Update preferences
      */
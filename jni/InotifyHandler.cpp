@@ -15,22 +15,29 @@
  */
 
 #include "InotifyHandler.hpp"
+#include "BinderMonitor.hpp"
 #include "DeviceMitigationStore.hpp"
 #include "EncoreConfigStore.hpp"
 
+#include <fstream>
+
 #include <Encore.hpp>
 #include <EncoreLog.hpp>
 #include <EncoreUtility.hpp>
 #include <GameRegistry.hpp>
 
-// signal_daemon_stop is defined in Main.cpp
+// signal_daemon_stop, on_gamelist_changed and on_nodes_restored are defined in Main.cpp
 extern void signal_daemon_stop();
+extern void on_gamelist_changed(const GameListDiff &diff);
+extern void on_nodes_restored();
 
 enum WatchContext {
     WATCH_CONTEXT_GAMELIST,
     WATCH_CONTEXT_CONFIG,
     WATCH_CONTEXT_DEVICE_MITIGATION,
     WATCH_CONTEXT_MODULE_UPDATE,
+    WATCH_CONTEXT_PACKAGES,
+    WATCH_CONTEXT_NODES_RESTORED,
 };
 
 void on_json_modified(const struct inotify_event *event, const std::string &path, int context, void *additional_data) {
@@ -38,7 +45,20 @@ void on_json_modified(const struct inotify_event *event, const std::string &path
 
     auto OnGamelistModified = [&](const std::string &path) -> void {
         LOGD_TAG("InotifyHandler", "Callback OnGamelistModified reached");
-        game_registry.load_from_json(path);
+        GameListDiff diff;
+        if (!game_registry.load_from_json(path, &diff) || diff.empty()) return;
+
+        // Changed flags don't turn games into non-games or the other way around
+        if (!diff.added.empty() || !diff.removed.empty()) {
+            BinderMonitor::get().invalidateGameCache();
+        }
+        on_gamelist_changed(diff);
+    };
+
+    auto OnPackagesChanged = [&]() -> void {
+        LOGD_TAG("InotifyHandler", "Callback OnPackagesChanged reached");
+        BinderMonitor::get().invalidatePackageCache();
+        BinderMonitor::get().primeUidCache(read_installed_packages());
     };
 
     auto OnDeviceMitigationModified = [&](const std::string &path) -> void {
@@ -71,10 +91,16 @@ void on_json_modified(const struct inotify_event *event, const std::string &path
             case WATCH_CONTEXT_GAMELIST: OnGamelistModified(path); break;
             case WATCH_CONTEXT_CONFIG: OnConfigModified(path); break;
             case WATCH_CONTEXT_DEVICE_MITIGATION: OnDeviceMitigationModified(path); break;
+            case WATCH_CONTEXT_NODES_RESTORED: on_nodes_restored(); break;
             default: break;
         }
     }
 
+    // PackageManager rewrites packages.list through a rename on every install, removal or update
+    if ((event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) && context == WATCH_CONTEXT_PACKAGES) {
+        OnPackagesChanged();
+    }
+
     // React when MODULE_UPDATE is created inside MODPATH directory
     if ((event->mask & IN_CREATE) && context == WATCH_CONTEXT_MODULE_UPDATE) {
         if (std::string(event->name) == "update") {
@@ -125,6 +151,19 @@ bool init_file_watcher(InotifyWatcher &watcher) {
             return false;
         }
 
+        // Not fatal, package names are still resolved, just never refreshed
+        InotifyWatcher::WatchReference packages_ref{PACKAGES_LIST, on_json_modified, WATCH_CONTEXT_PACKAGES, nullptr};
+        if (!watcher.addFile(packages_ref)) {
+            LOGW_TAG("InotifyWatcher", "Failed to add packages list watch, UID cache won't be invalidated");
+        }
+
+        // "encored restore" writes to this file to tell a running daemon, not fatal either
+        std::ofstream(NODES_RESTORED_FILE, std::ios::app);
+        InotifyWatcher::WatchReference restored_ref{NODES_RESTORED_FILE, on_json_modified, WATCH_CONTEXT_NODES_RESTORED, nullptr};
+        if (!watcher.addFile(restored_ref)) {
+            LOGW_TAG("InotifyWatcher", "Failed to add restore watch, restored nodes won't be rewritten");
+        }
+
         watcher.start();
         return true;
     } catch (const std::runtime_error &e) {
@@ -14,12 +14,14 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
 #include <thread>
-#include <mutex>
+#include <optional>
 #include <unistd.h>
 #include <signal.h>
 #include <fstream>
@@ -31,14 +33,20 @@
 #include "InotifyHandler.hpp"
 #include "Profiler.hpp"
 #include "BinderMonitor.hpp"
+#include "TransitionScheduler.hpp"
 
+#include <DeviceInfo.hpp>
 #include <Encore.hpp>
 #include <EncoreLog.hpp>
 #include <EncoreUtility.hpp>
+#include <GameDetector.hpp>
 #include <GameRegistry.hpp>
 #include <ModuleProperty.hpp>
+#include <PristineSnapshot.hpp>
+#include <ProcessScanner.hpp>
 #include <ShellUtility.hpp>
 #include <SignalHandler.hpp>
+#include <TweakBlob.hpp>
 
 namespace fs = std::filesystem;
 
@@ -48,21 +56,39 @@ namespace fs = std::filesystem;
 
 GameRegistry game_registry;
 
+// Games recognized by their engine, only touched by the executor thread
+static GameDetector game_detector;
+
+// Processes of the session's game, rescanned at most every 500 ms
+static ProcessScanner process_scanner;
+
 struct DaemonState {
     EncoreProfileMode cur_mode = PERFCOMMON;
     std::string active_package;
     pid_t active_game_pid = 0;
     uid_t active_game_uid = 0;
     pid_t last_applied_pid = 0;
+    bool applied_lite_mode = false;
+
+    // Last app reported in foreground, game or not
+    pid_t foreground_pid = 0;
+    uid_t foreground_uid = 0;
 
     bool screen_awake = true;
+    std::chrono::steady_clock::time_point screen_off_at{};
     bool battery_saver_state = false;
     bool game_requested_dnd = false;
     bool prev_dnd_state = false;
+
+    // Nodes were restored behind the engine, the next evaluation forgets what it wrote and
+    // runs perfcommon again
+    bool nodes_restored = false;
+
+    // An evaluation is running, events are then handled from its preemption checks
+    bool evaluating = false;
 };
 
 DaemonState g_state;
-std::mutex g_state_mtx;
 std::atomic<bool> daemon_stop_requested{false};
 
 // ---------------------------------------------------------------------------
@@ -90,6 +116,10 @@ void notify_fatal_error(const std::string &error_msg) {
 
 void signal_daemon_stop() {
     daemon_stop_requested.store(true, std::memory_order_relaxed);
+
+    // _exit skips atexit, restore the pristine values like any other stop does
+    SignalHandler::cleanup_before_exit();
+
     // Exit immediately since BinderMonitor::joinThreadPool() blocks the main thread
     _exit(0);
 }
@@ -98,22 +128,97 @@ void signal_daemon_stop() {
 // Helper functions
 // ---------------------------------------------------------------------------
 
-static std::string remove_null_char(std::string raw) {
-    if (auto null_pos = raw.find('\0'); null_pos != std::string::npos) {
-        raw.resize(null_pos);
+/**
+ * @brief Sets DND with a single binder transaction, launching `cmd` only if that is unavailable.
+ */
+static void apply_do_not_disturb(bool do_not_disturb) {
+    if (!BinderMonitor::get().setDoNotDisturb(do_not_disturb)) {
+        set_do_not_disturb(do_not_disturb);
     }
-    return raw;
 }
 
 static void clear_dnd_if_needed(DaemonState &state) {
     if (state.game_requested_dnd) {
-        set_do_not_disturb(state.prev_dnd_state);
+        apply_do_not_disturb(state.prev_dnd_state);
         state.game_requested_dnd = false;
     }
 }
 
+/**
+ * @brief Forgets the profile whose application a newer event cut short.
+ *
+ * The state may already describe the newer target, the evaluation scheduled for it
+ * applies the profile from scratch and converges from the partially written nodes.
+ */
+static void mark_preempted(DaemonState &state) {
+    LOGD("Profile transition preempted by a newer event");
+    state.cur_mode = PERFCOMMON;
+    state.last_applied_pid = 0;
+}
+
+/**
+ * @brief Looks up the settings of a session's game, unlisted detected games get the defaults while auto detection is on.
+ */
+static std::optional<EncoreGameList> find_session_game(const std::string &package_name) {
+    // A copy, the gamelist may be reloaded while the profile is applied
+    if (auto game = game_registry.find_game(package_name)) return game;
+    if (config_store.get_preferences().auto_detect_games && game_detector.is_known_game(package_name)) {
+        return EncoreGameList{package_name, false, false};
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Tells whether an app missing from the gamelist loads a game engine, if auto detection is on.
+ */
+static bool detect_game(uid_t uid, pid_t pid, std::string *package_name) {
+    if (!config_store.get_preferences().auto_detect_games) return false;
+
+    // Regular apps only, AID_APP_START..AID_APP_END within each user
+    const uid_t app_id = uid % 100000;
+    if (app_id < 10000 || app_id > 19999) return false;
+
+    std::string name = BinderMonitor::get().getPackageNameForUid(static_cast<int32_t>(uid));
+    if (name.empty()) return false;
+
+    const bool is_game = game_detector.is_game(name, pid);
+    game_detector.save(GAME_DETECTION_CACHE, DeviceInfo::get_build_fingerprint());
+    if (is_game) *package_name = std::move(name);
+    return is_game;
+}
+
+/**
+ * @brief Checks that the session's PID still belongs to its game, moving to another process of the game if not.
+ *
+ * The PID of a game that exited may already be reused, and the game may have restarted
+ * its main process before the event arrived.
+ *
+ * @return false if no process of the game runs anymore.
+ */
+static bool resolve_game_pid(DaemonState &state) {
+    const uid_t uid = state.active_game_uid != 0 ? state.active_game_uid : ProcessScanner::kAnyUid;
+    const auto is_session_pid = [&](const ProcessInfo &process) {
+        return process.pid == state.active_game_pid;
+    };
+
+    auto processes = process_scanner.find_package(state.active_package, uid);
+    if (std::none_of(processes.begin(), processes.end(), is_session_pid)) {
+        // A kept scan may predate the process, only a fresh one is conclusive
+        process_scanner.invalidate();
+        processes = process_scanner.find_package(state.active_package, uid);
+    }
+
+    if (processes.empty()) return false;
+    if (std::none_of(processes.begin(), processes.end(), is_session_pid)) {
+        LOGI("Game {} (PID: {}) is gone, following {} (PID: {})", state.active_package, state.active_game_pid,
+             processes.front().name, processes.front().pid);
+        state.active_game_pid = processes.front().pid;
+    }
+    return true;
+}
+
 [[nodiscard]] static bool apply_game_profile(DaemonState &state) {
-    auto *active_game = game_registry.find_game_ptr(state.active_package);
+    const auto active_game = find_session_game(state.active_package);
     if (!active_game) {
         LOGI("Game {} is no longer listed in registry", state.active_package);
         state.active_package.clear();
@@ -123,7 +228,7 @@ static void clear_dnd_if_needed(DaemonState &state) {
         return false;
     }
 
-    if (kill(state.active_game_pid, 0) != 0) {
+    if (!resolve_game_pid(state)) {
         LOGW("Game {} (PID: {}) exited while applying profile, aborting session",
              state.active_package, state.active_game_pid);
         state.active_package.clear();
@@ -134,54 +239,258 @@ static void clear_dnd_if_needed(DaemonState &state) {
     }
 
     state.cur_mode = PERFORMANCE_PROFILE;
+    state.last_applied_pid = state.active_game_pid;
     LOGI("Applying performance profile for {} (PID: {})", state.active_package, state.active_game_pid);
 
     const bool lite_mode = active_game->lite_mode || config_store.get_preferences().enforce_lite_mode;
-    apply_performance_profile(lite_mode, state.active_package, state.active_game_pid, state.active_game_uid);
+    state.applied_lite_mode = lite_mode;
+    if (!apply_performance_profile(lite_mode, state.active_package, state.active_game_pid, state.active_game_uid)) {
+        mark_preempted(state);
+        return true;
+    }
 
     if (active_game->enable_dnd) {
         state.game_requested_dnd = true;
-        set_do_not_disturb(true);
+        apply_do_not_disturb(true);
     } else {
         state.game_requested_dnd = false;
-        set_do_not_disturb(state.prev_dnd_state);
+        apply_do_not_disturb(state.prev_dnd_state);
     }
     return true;
 }
 
-static void evaluate_and_apply_profile(DaemonState &state) {
+/**
+ * @brief Applies the profile the current state calls for.
+ *
+ * @return Zero once done, or how long the performance profile is held before the state
+ *         has to be evaluated again.
+ */
+static std::chrono::milliseconds evaluate_and_apply_profile(DaemonState &state) {
+    using namespace std::chrono;
+
+    // Only here, between applies, no worker holds a node handle and no apply records writes
+    if (state.nodes_restored) {
+        state.nodes_restored = false;
+        invalidate_profile_state();
+        LOGI("Applying perfcommon again after restore");
+        run_perfcommon();
+    }
+
     // Track user's DND preference while we are not overriding it
     if (!state.game_requested_dnd) {
-        state.prev_dnd_state = (BinderMonitor::get().getZenMode() != 0);
+        state.prev_dnd_state = (BinderMonitor::get().getZenMode() > 0);
     }
 
     if (state.active_game_pid != 0 && state.screen_awake) {
         // Only skip if we are already in performance mode AND it's for the exact same game PID
-        if (state.cur_mode == PERFORMANCE_PROFILE && state.last_applied_pid == state.active_game_pid) return;
-        if (apply_game_profile(state)) {
-            state.last_applied_pid = state.active_game_pid;
-            return;
-        }
+        if (state.cur_mode == PERFORMANCE_PROFILE && state.last_applied_pid == state.active_game_pid) return 0ms;
+        if (apply_game_profile(state)) return 0ms;
+    }
+
+    // Keep performance for a while after screen off, the game is likely resumed right away
+    if (state.cur_mode == PERFORMANCE_PROFILE && state.active_game_pid != 0 && !state.screen_awake) {
+        const auto hold = milliseconds(config_store.get_transition().screen_off_hold_ms);
+        const auto held = duration_cast<milliseconds>(steady_clock::now() - state.screen_off_at);
+        if (held < hold) return hold - held;
     }
 
     if (state.battery_saver_state) {
-        if (state.cur_mode == POWERSAVE_PROFILE) return;
+        if (state.cur_mode == POWERSAVE_PROFILE) return 0ms;
         state.cur_mode = POWERSAVE_PROFILE;
         state.last_applied_pid = 0;
         state.active_game_uid = 0;
         LOGI("Applying powersave profile");
-        apply_powersave_profile();
+        if (!apply_powersave_profile()) {
+            mark_preempted(state);
+            return 0ms;
+        }
         clear_dnd_if_needed(state);
-        return;
+        return 0ms;
     }
 
-    if (state.cur_mode == BALANCE_PROFILE) return;
+    if (state.cur_mode == BALANCE_PROFILE) return 0ms;
     state.cur_mode = BALANCE_PROFILE;
     state.last_applied_pid = 0;
     state.active_game_uid = 0;
     LOGI("Applying balance profile");
-    apply_balance_profile();
+    if (!apply_balance_profile()) {
+        mark_preempted(state);
+        return 0ms;
+    }
     clear_dnd_if_needed(state);
+    return 0ms;
+}
+
+/**
+ * @brief Reconciles the session with a reloaded gamelist, only touching it if its game changed.
+ *
+ * @return Evaluate right away if the session changed, std::nullopt otherwise.
+ */
+static std::optional<std::chrono::milliseconds> reconcile_gamelist(DaemonState &state) {
+    if (state.active_game_pid == 0) {
+        // The app in foreground may just have been listed
+        std::string pkg;
+        if (state.foreground_pid == 0 || kill(state.foreground_pid, 0) != 0 ||
+            !BinderMonitor::get().isGameUid(state.foreground_uid, &pkg)) {
+            return std::nullopt;
+        }
+
+        state.active_package = pkg;
+        state.active_game_pid = state.foreground_pid;
+        state.active_game_uid = state.foreground_uid;
+        LOGI("Game {} in foreground was added to gamelist (PID: {})", pkg, state.foreground_pid);
+        return std::chrono::milliseconds(0);
+    }
+
+    const auto game = find_session_game(state.active_package);
+    if (!game) {
+        LOGI("Game {} was removed from gamelist, resetting profile", state.active_package);
+        clear_dnd_if_needed(state);
+        state.active_package.clear();
+        state.active_game_pid = 0;
+        state.last_applied_pid = 0;
+        return std::chrono::milliseconds(0);
+    }
+
+    // Not applied yet, the pending evaluation picks the new entry up anyway
+    if (state.cur_mode != PERFORMANCE_PROFILE || state.last_applied_pid != state.active_game_pid) {
+        return std::nullopt;
+    }
+
+    const bool lite_mode = game->lite_mode || config_store.get_preferences().enforce_lite_mode;
+    if (lite_mode == state.applied_lite_mode && game->enable_dnd == state.game_requested_dnd) {
+        return std::nullopt;
+    }
+
+    // Reapplying only writes the nodes that differ between full and lite performance
+    LOGI("Gamelist entry of {} changed, reapplying performance profile", state.active_package);
+    state.last_applied_pid = 0;
+    return std::chrono::milliseconds(0);
+}
+
+/**
+ * @brief Folds a binder event into the daemon state.
+ *
+ * @return Debounce before the state is evaluated, or std::nullopt if nothing changed.
+ */
+static std::optional<std::chrono::milliseconds> handle_event(DaemonState &state, const TransitionEvent &event) {
+    const auto debounce = std::chrono::milliseconds(config_store.get_transition().debounce_ms);
+
+    switch (event.type) {
+        case TransitionEvent::Type::Refresh:
+            return std::chrono::milliseconds(0);
+
+        case TransitionEvent::Type::ForegroundActivity: {
+            LOGT("onForegroundActivitiesChanged: pid={}, uid={}, foreground={}", event.pid, event.uid, event.value);
+
+            // Ignore background events to prevent clearing DND or game state.
+            // We can't rely on foreground info from some devices as it can be stale.
+            // DND will remain active as long as the game process is alive.
+            if (!event.value) return std::nullopt;
+            state.foreground_pid = event.pid;
+            state.foreground_uid = event.uid;
+            if (state.active_game_pid == event.pid) return std::nullopt;
+
+            // Non-games are answered from the UID cache without any IPC
+            std::string pkg;
+            if (!BinderMonitor::get().isGameUid(event.uid, &pkg) && !detect_game(event.uid, event.pid, &pkg)) {
+                return std::nullopt;
+            }
+
+            // Switching to a new game (or starting a game)
+            state.active_package = pkg;
+            state.active_game_pid = event.pid;
+            state.active_game_uid = event.uid;
+            LOGI("Game {} came to foreground (PID: {})", pkg, event.pid);
+            return debounce;
+        }
+
+        case TransitionEvent::Type::ProcessDied:
+            LOGT("onProcessDied: pid={}, uid={}", event.pid, event.uid);
+            if (state.active_game_pid != event.pid) return std::nullopt;
+
+            LOGI("Game {} (PID: {}) exited, resetting profile", state.active_package, event.pid);
+            clear_dnd_if_needed(state);
+            state.active_package.clear();
+            state.active_game_pid = 0;
+            state.last_applied_pid = 0;
+            return debounce;
+
+        case TransitionEvent::Type::DisplayState:
+            LOGT("DisplayStateCallback: isInteractive={}", event.value);
+            if (state.screen_awake && !event.value) {
+                state.screen_off_at = event.time;
+            }
+            state.screen_awake = event.value;
+            return debounce;
+
+        case TransitionEvent::Type::PowerSave:
+            LOGT("PowerSaveCallback: isPowerSave={}", event.value);
+            state.battery_saver_state = event.value;
+            return debounce;
+
+        case TransitionEvent::Type::GameListChanged:
+            return reconcile_gamelist(state);
+
+        case TransitionEvent::Type::NodesRestored:
+            // Values written before are gone, keep the restored ones until the next transition.
+            // An apply in progress is cut short instead, it already wrote over some of them.
+            LOGI("Nodes were restored to their pristine values, rewriting everything on the next transition");
+            state.nodes_restored = true;
+            state.cur_mode = PERFCOMMON;
+            state.last_applied_pid = 0;
+            if (state.evaluating) return std::chrono::milliseconds(0);
+            return std::nullopt;
+    }
+
+    return std::nullopt;
+}
+
+/**
+ * @brief Profile executor, the only thread touching g_state once the daemon runs.
+ */
+static TransitionScheduler transition_scheduler(
+    [](const TransitionEvent &event) {
+        return handle_event(g_state, event);
+    },
+    []() {
+        struct Evaluating {
+            Evaluating() { g_state.evaluating = true; }
+            ~Evaluating() { g_state.evaluating = false; }
+        } evaluating;
+        return evaluate_and_apply_profile(g_state);
+    },
+    []() {
+        return std::chrono::milliseconds(config_store.get_transition().max_latency_ms);
+    }
+);
+
+/**
+ * @brief Hands a binder event to the profile executor, binder threads must not do more.
+ */
+static void post_event(TransitionEvent::Type type, bool value = false, int32_t pid = 0, int32_t uid = 0) {
+    transition_scheduler.post(TransitionEvent{
+        .type = type,
+        .value = value,
+        .pid = pid,
+        .uid = uid,
+        .time = std::chrono::steady_clock::now()
+    });
+}
+
+/**
+ * @brief Called by the file watcher after a gamelist reload that changed something.
+ */
+void on_gamelist_changed(const GameListDiff &diff) {
+    LOGD("Gamelist changed: {} added, {} removed, {} changed", diff.added.size(), diff.removed.size(), diff.changed.size());
+    post_event(TransitionEvent::Type::GameListChanged);
+}
+
+/**
+ * @brief Called by the file watcher once "encored restore" wrote the pristine values back.
+ */
+void on_nodes_restored() {
+    post_event(TransitionEvent::Type::NodesRestored);
 }
 
 // ---------------------------------------------------------------------------
@@ -189,87 +498,82 @@ static void evaluate_and_apply_profile(DaemonState &state) {
 // ---------------------------------------------------------------------------
 
 static void encore_main_daemon() {
-    run_perfcommon();
+    using namespace std::chrono;
 
-    auto& binder = BinderMonitor::get();
-    if (!binder.initialize()) {
-        LOGE("Failed to initialize BinderMonitor");
-        notify_fatal_error("Failed to initialize BinderMonitor");
-        return;
-    }
+    const auto startup = steady_clock::now();
+    init_profile_engine();
+    init_pristine_snapshot();
+    SignalHandler::on_cleanup([]() {
+        restore_pristine();
+    });
 
-    // Initialize state
-    {
-        std::lock_guard<std::mutex> lk(g_state_mtx);
-        g_state.screen_awake = true;
-        g_state.battery_saver_state = binder.isPowerSave();
-        g_state.prev_dnd_state = (binder.getZenMode() != 0);
-    }
+    // Verdicts of previous runs, games are rescanned once the file is gone
+    game_detector.load(GAME_DETECTION_CACHE, DeviceInfo::get_build_fingerprint());
 
-    ProcessObserverCallbacks pocbs;
+    // Initialize state, the executor thread owns it once started. Screen and Battery Saver
+    // states are reported as events once their services attach.
+    g_state.screen_awake = true;
 
-    pocbs.onForegroundActivitiesChanged = [&binder](int32_t pid, int32_t uid, bool foreground) {
-        std::lock_guard<std::mutex> lk(g_state_mtx);
-        LOGT("onForegroundActivitiesChanged: pid={}, uid={}, foreground={}", pid, uid, foreground);
+    // Callbacks go first, BinderMonitor reports initial states through them
+    auto& binder = BinderMonitor::get();
+    binder.setGameClassifier([](const std::string &package_name) {
+        return game_registry.is_game_registered(package_name);
+    });
 
-        // Ignore background events to prevent clearing DND or game state.
-        // We can't rely on foreground info from some devices as it can be stale.
-        // DND will remain active as long as the game process is alive.
-        if (!foreground) {
-            return;
-        }
+    // Every installed app is classified up front, foreground changes then never wait on PackageManager
+    binder.primeUidCache(read_installed_packages());
 
-        std::string pkg = remove_null_char(binder.getPackageNameForUid(uid));
-        bool is_game = !pkg.empty() && game_registry.is_game_registered(pkg);
-        if (!is_game) return;
+    ProcessObserverCallbacks pocbs;
 
-        if (g_state.active_game_pid != pid) {
-            // Switching to a new game (or starting a game)
-            g_state.active_package = pkg;
-            g_state.active_game_pid = pid;
-            g_state.active_game_uid = uid;
-            LOGI("Game {} came to foreground (PID: {})", pkg, pid);
-            evaluate_and_apply_profile(g_state);
-        }
+    pocbs.onForegroundActivitiesChanged = [](int32_t pid, int32_t uid, bool foreground) {
+        post_event(TransitionEvent::Type::ForegroundActivity, foreground, pid, uid);
     };
 
     pocbs.onProcessDied = [](int32_t pid, int32_t uid) {
-        std::lock_guard<std::mutex> lk(g_state_mtx);
-        LOGT("onProcessDied: pid={}, uid={}", pid, uid);
-
-        if (g_state.active_game_pid == pid) {
-            LOGI("Game {} (PID: {}) exited, resetting profile", g_state.active_package, pid);
-            clear_dnd_if_needed(g_state);
-            g_state.active_package.clear();
-            g_state.active_game_pid = 0;
-            g_state.last_applied_pid = 0;
-            evaluate_and_apply_profile(g_state);
-        }
+        post_event(TransitionEvent::Type::ProcessDied, false, pid, uid);
     };
 
     binder.setProcessObserverCallbacks(pocbs);
 
     binder.setDisplayStateCallback([](bool isInteractive) {
-        std::lock_guard<std::mutex> lk(g_state_mtx);
-        LOGT("DisplayStateCallback: isInteractive={}", isInteractive);
-        g_state.screen_awake = isInteractive;
-        evaluate_and_apply_profile(g_state);
+        post_event(TransitionEvent::Type::DisplayState, isInteractive);
     });
 
     binder.setPowerSaveCallback([](bool isPowerSave) {
-        std::lock_guard<std::mutex> lk(g_state_mtx);
-        LOGT("PowerSaveCallback: isPowerSave={}", isPowerSave);
-        g_state.battery_saver_state = isPowerSave;
-        evaluate_and_apply_profile(g_state);
+        post_event(TransitionEvent::Type::PowerSave, isPowerSave);
     });
 
-    // Initial profile evaluation
-    {
-        std::lock_guard<std::mutex> lk(g_state_mtx);
-        evaluate_and_apply_profile(g_state);
+    if (!binder.initialize()) {
+        LOGE("Failed to initialize BinderMonitor");
+        notify_fatal_error("Failed to initialize BinderMonitor");
+        return;
+    }
+
+    // Services are acquired in the background meanwhile, events queue until the executor runs
+    run_perfcommon();
+    LOGI("Applied perfcommon after {} ms", duration_cast<milliseconds>(steady_clock::now() - startup).count());
+
+    // Let a pending state change cut short a stale transition. Set before the executor starts,
+    // it reads the check during every apply.
+    set_profile_preempt([]() {
+        return transition_scheduler.preempted();
+    });
+
+    if (!transition_scheduler.start()) {
+        notify_fatal_error("Failed to start profile executor");
+        return;
+    }
+
+    if (!binder.waitForCoreServices()) {
+        LOGE("Failed to attach process observer");
+        notify_fatal_error("Failed to attach process observer");
+        return;
     }
 
-    LOGI("Encore Tweaks daemon started");
+    // Initial profile evaluation, without waiting for a quiet period
+    post_event(TransitionEvent::Type::Refresh);
+
+    LOGI("Encore Tweaks daemon started after {} ms", duration_cast<milliseconds>(steady_clock::now() - startup).count());
     set_module_description_status("\xF0\x9F\x98\x8B Tweaks applied successfully");
 
     // Block main thread until daemon is stopped
@@ -389,6 +693,33 @@ int cmd_check_gamelist() {
     return EXIT_SUCCESS;
 }
 
+int cmd_compile_tweaks(const std::string& json_path, const std::string& blob_path) {
+    if (!compile_tweaks(json_path, blob_path)) {
+        std::cerr << "\033[31mERROR:\033[0m Failed to compile " << json_path << ", see " << LOG_FILE << std::endl;
+        return EXIT_FAILURE;
+    }
+    // stderr output is intentional for module installation
+    std::cerr << "Compiled " << json_path << " into " << blob_path << std::endl;
+    return EXIT_SUCCESS;
+}
+
+int cmd_restore() {
+    PristineSnapshot snapshot;
+    if (!snapshot.load(PRISTINE_SNAPSHOT, DeviceInfo::get_boot_id())) {
+        std::cerr << "\033[31mERROR:\033[0m No pristine snapshot of the current boot, nothing to restore" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const size_t restored = snapshot.restore();
+    std::cout << "Restored " << restored << " of " << snapshot.size() << " nodes" << std::endl;
+
+    // A running daemon watches this file, it would otherwise skip nodes it believes to hold its values
+    if (access(NODES_RESTORED_FILE, F_OK) == 0) {
+        std::ofstream(NODES_RESTORED_FILE, std::ios::trunc) << restored << '\n';
+    }
+    return EXIT_SUCCESS;
+}
+
 // ---------------------------------------------------------------------------
 // Usage & Help
 // ---------------------------------------------------------------------------
@@ -400,6 +731,8 @@ void print_usage(const std::string & program_name) {
     std::cout << "  daemon               Start Encore Tweaks daemon\n";
     std::cout << "  setup_gamelist       Setup initial gamelist from base file\n";
     std::cout << "  check_gamelist       Validate gamelist file\n";
+    std::cout << "  compile_tweaks       Compile declarative profile tweaks\n";
+    std::cout << "  restore              Restore the original values of tweaked nodes\n";
     std::cout << "  version              Show version information\n";
     std::cout << "\nGlobal Options:\n";
     std::cout << "  -h, --help           Show this help message\n";
@@ -424,6 +757,20 @@ void print_check_gamelist_help(const std::string & program_name) {
     std::cout << "Validate the gamelist file and print registered games count.\n";
 }
 
+void print_compile_tweaks_help(const std::string & program_name) {
+    std::cout << "Usage: " << program_name << " compile_tweaks [json_path] [blob_path]\n\n";
+    std::cout << "Compile declarative profile tweaks into the binary form loaded by the daemon.\n\n";
+    std::cout << "Arguments:\n";
+    std::cout << "  [json_path]          Tweak definitions (default: " << PROFILE_TWEAKS_FILE << ")\n";
+    std::cout << "  [blob_path]          Compiled output (default: " << PROFILE_TWEAKS_BLOB << ")\n";
+}
+
+void print_restore_help(const std::string & program_name) {
+    std::cout << "Usage: " << program_name << " restore\n\n";
+    std::cout << "Write back the values every tweaked node had before the daemon first ran in this boot.\n";
+    std::cout << "A running daemon is notified and writes its profile in full on the next transition.\n";
+}
+
 // ---------------------------------------------------------------------------
 // Entry point
 // ---------------------------------------------------------------------------
@@ -489,6 +836,30 @@ int main(int argc, char *argv[]) {
         return cmd_check_gamelist();
     }
 
+    if (cmd == "compile_tweaks") {
+        if (is_sub_help) {
+            print_compile_tweaks_help(program_name);
+            return EXIT_SUCCESS;
+        }
+
+        if (argc > 4) {
+            std::cerr << "\033[31mERROR:\033[0m Invalid arguments.\n";
+            print_compile_tweaks_help(program_name);
+            return EXIT_FAILURE;
+        }
+
+        return cmd_compile_tweaks(argc >= 3 ? argv[2] : PROFILE_TWEAKS_FILE, argc >= 4 ? argv[3] : PROFILE_TWEAKS_BLOB);
+    }
+
+    if (cmd == "restore") {
+        if (is_sub_help) {
+            print_restore_help(program_name);
+            return EXIT_SUCCESS;
+        }
+
+        return cmd_restore();
+    }
+
     std::cerr << "\033[31mERROR:\033[0m Unknown command: " << cmd << "\n";
     std::cerr << "See '" << program_name << " --help' for available commands.\n";
     return EXIT_FAILURE;
@@ -15,7 +15,7 @@
  */
 
 #include <algorithm>
-#include <cstdlib>
+#include <sys/stat.h>
 
 #include "Encore.hpp"
 #include "EncoreLog.hpp"
@@ -25,45 +25,133 @@
 #include "DeviceMitigationStore.hpp"
 #include "EncoreConfigStore.hpp"
 
+#include <DeviceInfo.hpp>
 #include <EncoreUtility.hpp>
+#include <PristineSnapshot.hpp>
+#include <ProfileEngine.hpp>
+#include <TweakBlob.hpp>
 
-void set_profiler_env_vars() {
+static ProfileEngine profile_engine;
+static PristineSnapshot pristine_snapshot;
+
+ProfileOptions build_profile_options(bool lite_mode) {
     // Get preferences from config store
     auto prefs = config_store.get_preferences();
 
-    // Clear all existing _ENCORE_* environment variables
-    extern char **environ;
-    for (char **env = environ; *env; ++env) {
-        std::string env_str(*env);
-        if (env_str.find("ENCORE_") == 0) {
-            // Extract the variable name (up to '=')
-            size_t eq_pos = env_str.find('=');
-            if (eq_pos != std::string::npos) {
-                std::string var_name = env_str.substr(0, eq_pos);
-                unsetenv(var_name.c_str());
-            }
-        }
-    }
+    ProfileOptions options;
+    options.soc = read_soc_vendor(SOC_RECOGNITION_FILE);
+    options.lite_mode = lite_mode;
 
     // Use cached mitigation items instead of re-evaluating rules
     auto mitigation_items = device_mitigation_store.get_cached_mitigation_items(prefs.use_device_mitigation);
 
-    // Set environment variable for mitigation items
     for (const auto &item : mitigation_items) {
-        std::string env_var = "ENCORE_" + item;
-        std::transform(env_var.begin(), env_var.end(), env_var.begin(), [](unsigned char c) {
+        std::string name = item;
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) {
             if (!std::isalnum(c) && c != '_') return '_';
             return static_cast<char>(std::toupper(c));
         });
 
-        setenv(env_var.c_str(), "1", 1);
-        LOGD_TAG("Profiler", "Set mitigation env var: {}", env_var);
+        if (name == "DISABLE_DDR_TWEAK") {
+            options.disable_ddr_tweak = true;
+        } else if (name == "NO_PERFORMANCE_CPUGOV") {
+            options.no_performance_cpugov = true;
+        } else if (name == "QCOM_NO_GPU_POWERSAVE") {
+            options.qcom_no_gpu_powersave = true;
+        } else {
+            LOGW_TAG("Profiler", "Unknown mitigation item: {}", item);
+            continue;
+        }
+
+        LOGD_TAG("Profiler", "Mitigation enabled: {}", name);
     }
 
-    // Set CPU Governor variables
+    // CPU Governor preferences
     EncoreConfigStore::CPUGovernor cpu_governor_preference = config_store.get_cpu_governor();
-    setenv("ENCORE_BALANCED_CPUGOV", cpu_governor_preference.balance.c_str(), 1);
-    setenv("ENCORE_POWERSAVE_CPUGOV", cpu_governor_preference.powersave.c_str(), 1);
+    options.balance_cpugov = cpu_governor_preference.balance;
+    options.powersave_cpugov = cpu_governor_preference.powersave;
+
+    return options;
+}
+
+/**
+ * @brief Maps the compiled declarative tweaks, recompiling them if the blob is missing or outdated.
+ */
+static void load_declared_tweaks() {
+    struct stat json_st{}, blob_st{};
+    if (stat(PROFILE_TWEAKS_FILE, &json_st) != 0) {
+        LOGD_TAG("Profiler", "No declared tweaks");
+        return;
+    }
+
+    // Normally compiled at install time, this only covers manual edits
+    if (stat(PROFILE_TWEAKS_BLOB, &blob_st) != 0 || blob_st.st_mtime < json_st.st_mtime) {
+        if (!compile_tweaks(PROFILE_TWEAKS_FILE, PROFILE_TWEAKS_BLOB)) {
+            LOGE_TAG("Profiler", "Failed to compile {}", PROFILE_TWEAKS_FILE);
+            return;
+        }
+    }
+
+    if (!profile_engine.load_tweaks(PROFILE_TWEAKS_BLOB)) {
+        LOGE_TAG("Profiler", "Failed to load {}", PROFILE_TWEAKS_BLOB);
+    }
+}
+
+void init_profile_engine() {
+    load_declared_tweaks();
+
+    // Nodes and tables only change with the kernel or a system update
+    const std::string identity = DeviceInfo::get_kernel_uname() + " " + DeviceInfo::get_build_fingerprint();
+    FreqTableCache &freq_tables = profile_engine.freq_tables();
+    HardwareManifest &manifest = profile_engine.manifest();
+
+    if (manifest.load(HARDWARE_MANIFEST, identity) && freq_tables.load(FREQ_TABLE_CACHE, identity)) {
+        // Absent nodes may belong to a vendor module that loaded late when the manifest was recorded
+        if (manifest.recheck_absent() != 0 && !manifest.save(HARDWARE_MANIFEST, identity)) {
+            LOGW_TAG("Profiler", "Unable to persist hardware manifest");
+        }
+        return;
+    }
+
+    manifest.clear();
+    freq_tables.clear();
+    profile_engine.discover(build_profile_options(false));
+
+    if (!manifest.save(HARDWARE_MANIFEST, identity)) {
+        LOGW_TAG("Profiler", "Unable to persist hardware manifest");
+    }
+
+    if (!freq_tables.save(FREQ_TABLE_CACHE, identity)) {
+        LOGW_TAG("Profiler", "Unable to persist frequency table cache");
+    }
+}
+
+void init_pristine_snapshot() {
+    const std::string &boot_id = DeviceInfo::get_boot_id();
+    const ProfileOptions options = build_profile_options(false);
+
+    // A daemon restarted within the same boot finds the nodes already tweaked,
+    // so only the first run of a boot may capture them.
+    if (!pristine_snapshot.load(PRISTINE_SNAPSHOT, boot_id)) {
+        pristine_snapshot.capture(profile_engine.snapshot_nodes(options));
+        if (!pristine_snapshot.save(PRISTINE_SNAPSHOT, boot_id)) {
+            LOGW_TAG("Profiler", "Unable to persist pristine snapshot");
+        }
+    }
+
+    profile_engine.set_pristine(&pristine_snapshot, options);
+}
+
+size_t restore_pristine() noexcept {
+    return pristine_snapshot.restore();
+}
+
+void invalidate_profile_state() {
+    profile_engine.invalidate();
+}
+
+void set_profile_preempt(std::function<bool()> check) {
+    profile_engine.set_preempt(std::move(check));
 }
 
 void run_perfcommon(void) {
@@ -75,65 +163,65 @@ void run_perfcommon(void) {
         return;
     }
 
-    set_profiler_env_vars();
-
-    if (system("encore_profiler perfcommon")) {
-        LOGE("Unable to execute profiler changes to perfcommon");
+    if (profile_engine.apply(PERFCOMMON, build_profile_options(false)) == 0) {
+        LOGE("Unable to apply profiler changes to perfcommon");
     }
 }
 
-void apply_performance_profile(bool lite_mode, std::string game_pkg, pid_t game_pid, uid_t game_uid) {
+bool apply_performance_profile(bool lite_mode, std::string game_pkg, pid_t game_pid, uid_t game_uid) {
     write2file(GAME_INFO, game_pkg, " ", game_pid, " ", game_uid, "\n");
     write2file(PROFILE_MODE, static_cast<int>(PERFORMANCE_PROFILE), "\n");
 
     if (config_store.get_preferences().disable_tweaks) {
         LOGI_TAG("Profiler", "Tweaks are disabled in config, skipping performance profile");
-        return;
+        return true;
     }
 
-    set_profiler_env_vars();
-
     if (lite_mode) {
         LOGD("Lite mode is enabled");
-        if (system("encore_profiler performance_lite") != 0) {
-            LOGE("Unable to execute profiler changes to performance_lite");
-        }
-        return;
     }
 
-    if (system("encore_profiler performance") != 0) {
-        LOGE("Unable to execute profiler changes to performance");
+    const size_t applied = profile_engine.apply(PERFORMANCE_PROFILE, build_profile_options(lite_mode));
+    if (profile_engine.preempted()) return false;
+
+    if (applied == 0) {
+        LOGE("Unable to apply profiler changes to performance");
     }
+    return true;
 }
 
-void apply_balance_profile() {
+bool apply_balance_profile() {
     write2file(GAME_INFO, "NULL 0 0\n");
     write2file(PROFILE_MODE, static_cast<int>(BALANCE_PROFILE), "\n");
 
     if (config_store.get_preferences().disable_tweaks) {
         LOGI_TAG("Profiler", "Tweaks are disabled in config, skipping balance profile");
-        return;
+        return true;
     }
 
-    set_profiler_env_vars();
+    const size_t applied = profile_engine.apply(BALANCE_PROFILE, build_profile_options(false));
+    if (profile_engine.preempted()) return false;
 
-    if (system("encore_profiler balance") != 0) {
-        LOGE("Unable to execute profiler changes to balance");
+    if (applied == 0) {
+        LOGE("Unable to apply profiler changes to balance");
     }
+    return true;
 }
 
-void apply_powersave_profile() {
+bool apply_powersave_profile() {
     write2file(GAME_INFO, "NULL 0 0\n");
     write2file(PROFILE_MODE, static_cast<int>(POWERSAVE_PROFILE), "\n");
 
     if (config_store.get_preferences().disable_tweaks) {
         LOGI_TAG("Profiler", "Tweaks are disabled in config, skipping powersave profile");
-        return;
+        return true;
     }
 
-    set_profiler_env_vars();
+    const size_t applied = profile_engine.apply(POWERSAVE_PROFILE, build_profile_options(false));
+    if (profile_engine.preempted()) return false;
 
-    if (system("encore_profiler powersave") != 0) {
-        LOGE("Unable to execute profiler changes to powersave");
+    if (applied == 0) {
+        LOGE("Unable to apply profiler changes to powersave");
     }
+    return true;
 }
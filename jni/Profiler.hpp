@@ -14,12 +14,55 @@
 * limitations under the License.
 */
 
+#include <functional>
+#include <string>
+
+#include <ProfileEngine.hpp>
+
+/**
+ * @brief Builds profile engine options from the current config and device mitigation
+ *
+ * @param lite_mode Whether the profile should use lite mode.
+ */
+ProfileOptions build_profile_options(bool lite_mode);
+
 /**
- * @brief Sets all environment variables for the profiler
+ * @brief Loads declared tweaks, the hardware manifest and the frequency table cache, rediscovering and persisting them if missing or stale
  */
-void set_profiler_env_vars();
+void init_profile_engine();
 
+/**
+ * @brief Captures the original value of every node profiles touch, or loads the capture of the current boot
+ *
+ * Must run before the first profile is applied.
+ */
+void init_pristine_snapshot();
+
+/**
+ * @brief Writes every captured original value back, safe to call from a signal handler
+ *
+ * @return Number of nodes restored.
+ */
+size_t restore_pristine() noexcept;
+
+/**
+ * @brief Forgets what the profile engine wrote, call once nodes were changed behind its back
+ *
+ * The next transition then writes every node of its profile again.
+ */
+void invalidate_profile_state();
+
+/**
+ * @brief Sets the check polled while a profile is applied, see ProfileEngine::set_preempt()
+ *
+ * @param check Returns true once a newer target profile is pending.
+ */
+void set_profile_preempt(std::function<bool()> check);
+
+/**
+ * @brief Profile transitions, return false if preempted before the profile was fully applied
+ */
 void run_perfcommon(void);
-void apply_performance_profile(bool lite_mode, std::string game_pkg, pid_t game_pid, uid_t game_uid);
-void apply_balance_profile();
-void apply_powersave_profile();
+bool apply_performance_profile(bool lite_mode, std::string game_pkg, pid_t game_pid, uid_t game_uid);
+bool apply_balance_profile();
+bool apply_powersave_profile();
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TransitionScheduler.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <EncoreLog.hpp>
+
+TransitionScheduler::TransitionScheduler(Handler handler, Evaluator evaluator, MaxLatency max_latency)
+    : handler_(std::move(handler))
+    , evaluator_(std::move(evaluator))
+    , max_latency_(std::move(max_latency))
+    , event_fd_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+}
+
+TransitionScheduler::~TransitionScheduler() {
+    stop();
+
+    if (event_fd_ >= 0) {
+        close(event_fd_);
+    }
+}
+
+bool TransitionScheduler::start() {
+    if (alive_.load(std::memory_order_acquire)) return true;
+
+    if (event_fd_ < 0) {
+        LOGE_TAG("TransitionScheduler", "Failed to initialize eventfd");
+        return false;
+    }
+
+    alive_.store(true, std::memory_order_release);
+    try {
+        thread_ = std::thread(&TransitionScheduler::run, this);
+    } catch (const std::system_error &e) {
+        alive_.store(false, std::memory_order_release);
+        LOGE_TAG("TransitionScheduler", "Failed to create thread: {}", e.what());
+        return false;
+    }
+
+    return true;
+}
+
+void TransitionScheduler::stop() {
+    bool expected = true;
+    if (alive_.compare_exchange_strong(expected, false)) {
+        uint64_t val = 1;
+        ssize_t ret = write(event_fd_, &val, sizeof(val));
+        (void)ret;
+
+        if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
+            thread_.join();
+        }
+    }
+}
+
+void TransitionScheduler::post(const TransitionEvent &event) {
+    queue_.push(event);
+
+    // Events posted before start() are picked up once the thread runs
+    uint64_t val = 1;
+    ssize_t ret = write(event_fd_, &val, sizeof(val));
+    (void)ret;
+}
+
+bool TransitionScheduler::preempted() {
+    return drain();
+}
+
+bool TransitionScheduler::drain() {
+    bool changed = false;
+    TransitionEvent event;
+
+    while (queue_.pop(event)) {
+        std::optional<std::chrono::milliseconds> debounce;
+        try {
+            debounce = handler_(event);
+        } catch (const std::exception &e) {
+            LOGE_TAG("TransitionScheduler", "Failed to handle event: {}", e.what());
+        }
+        if (!debounce) continue;
+
+        // New events end a hold, and a zero debounce must not be postponed by an earlier, longer one
+        const auto now = Clock::now();
+        const auto deadline = now + *debounce;
+        const bool extend = pending_ && !holding_ && debounce->count() > 0;
+        if (extend) {
+            // Never earlier than already scheduled, never later than the burst allows
+            deadline_ = std::max(deadline_, std::min(deadline, latest_deadline_));
+        } else {
+            deadline_ = deadline;
+            latest_deadline_ = now + std::max(*debounce, max_latency_());
+        }
+        pending_ = true;
+        holding_ = false;
+        changed = true;
+    }
+
+    return changed;
+}
+
+void TransitionScheduler::run() {
+    pthread_setname_np(pthread_self(), "ProfileExecutor");
+
+    struct pollfd pfd{};
+    pfd.fd = event_fd_;
+    pfd.events = POLLIN;
+
+    while (alive_.load(std::memory_order_acquire)) {
+        // Drain events first, a value pushed during the previous drain already rang the eventfd
+        drain();
+
+        const auto now = Clock::now();
+        if (pending_ && now >= deadline_) {
+            pending_ = false;
+
+            std::chrono::milliseconds retry{0};
+            try {
+                retry = evaluator_();
+            } catch (const std::exception &e) {
+                LOGE_TAG("TransitionScheduler", "Profile evaluation failed: {}", e.what());
+            }
+
+            // A preempted evaluation already has its successor scheduled
+            if (retry.count() > 0 && !pending_) {
+                LOGD_TAG("TransitionScheduler", "Holding current profile for {} ms", retry.count());
+                deadline_ = Clock::now() + retry;
+                pending_ = true;
+                holding_ = true;
+            }
+            continue;
+        }
+
+        // Sleep until an event arrives or the quiet period is over
+        int timeout = -1;
+        if (pending_) {
+            timeout = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(deadline_ - now).count());
+        }
+
+        int ret = poll(&pfd, 1, timeout);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            LOGE_TAG("TransitionScheduler", "Poll failed: {}", strerror(errno));
+            break;
+        }
+
+        if (pfd.revents & POLLIN) {
+            uint64_t val;
+            ssize_t rd = read(event_fd_, &val, sizeof(val));
+            (void)rd;
+        }
+    }
+}
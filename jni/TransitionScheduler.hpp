@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <thread>
+
+#include <MpscQueue.hpp>
+
+/**
+ * @brief State change reported by a binder callback.
+ */
+struct TransitionEvent {
+    enum class Type : uint8_t {
+        Refresh,            /// Evaluate the current state right away
+        ForegroundActivity, /// pid, uid, value = foreground
+        ProcessDied,        /// pid, uid
+        DisplayState,       /// value = interactive
+        PowerSave,          /// value = battery saver active
+        GameListChanged,    /// Gamelist reloaded with changes
+        NodesRestored,      /// Pristine values were written back by "encored restore"
+    };
+
+    Type type = Type::Refresh;
+    bool value = false;
+    int32_t pid = 0;
+    int32_t uid = 0;
+    std::chrono::steady_clock::time_point time{}; /// When the event was received
+};
+
+/**
+ * @class TransitionScheduler
+ * @brief Single profile executor thread fed by a lock-free event queue.
+ *
+ * Binder threads only post events, which costs a queue push and an eventfd write. The
+ * executor thread folds events into the daemon state and coalesces them, every relevant
+ * event pushes the evaluation deadline out by its debounce window, so a burst of events
+ * (screen off/on, hopping between apps) only evaluates the state they settle in. A burst
+ * can't push it out further than the max latency after its first event, so a steady
+ * stream of events still gets evaluated.
+ * The evaluation may ask to be retried later, which implements hysteresis such as
+ * keeping the performance profile for a while after the screen turned off. A running
+ * evaluation may poll preempted() to give up on a target that became stale.
+ */
+class TransitionScheduler {
+public:
+    /**
+     * @brief Folds an event into the state, runs on the executor thread.
+     *
+     * @return Debounce before evaluating, zero evaluates right away, or std::nullopt
+     *         if the event didn't change anything.
+     */
+    using Handler = std::function<std::optional<std::chrono::milliseconds>(const TransitionEvent &)>;
+
+    /**
+     * @brief Evaluates the current state and applies the resulting profile.
+     *
+     * @return Zero once done, or how long the current profile has to be kept before
+     *         the state is evaluated again.
+     */
+    using Evaluator = std::function<std::chrono::milliseconds()>;
+
+    /**
+     * @brief Longest a burst of events may postpone the evaluation, read when a burst starts.
+     */
+    using MaxLatency = std::function<std::chrono::milliseconds()>;
+
+    TransitionScheduler(Handler handler, Evaluator evaluator, MaxLatency max_latency);
+    ~TransitionScheduler();
+
+    TransitionScheduler(const TransitionScheduler &) = delete;
+    TransitionScheduler &operator=(const TransitionScheduler &) = delete;
+
+    /**
+     * @brief Starts the executor thread, call after daemonizing.
+     *
+     * @return true if the thread was started, false otherwise.
+     */
+    bool start();
+
+    /**
+     * @brief Stops the executor thread, dropping any pending evaluation.
+     */
+    void stop();
+
+    /**
+     * @brief Queues an event for the executor thread, never blocks.
+     */
+    void post(const TransitionEvent &event);
+
+    /**
+     * @brief Folds events posted since the evaluation started, only call from the evaluator.
+     *
+     * @return true if any of them changed the state, so the running evaluation is stale.
+     */
+    bool preempted();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Handler handler_;
+    Evaluator evaluator_;
+    MaxLatency max_latency_;
+    MpscQueue<TransitionEvent> queue_;
+    std::thread thread_;
+    std::atomic<bool> alive_{false};
+    int event_fd_; /// Eventfd waking the executor on new events and shutdown
+
+    // Executor thread only
+    Clock::time_point deadline_{};
+    Clock::time_point latest_deadline_{}; /// Bound on extensions, max latency after the first event of a burst
+    bool pending_ = false;
+    bool holding_ = false; /// Pending evaluation was requested by the evaluator to end a hold
+
+    /**
+     * @brief Hands queued events to the handler and schedules the evaluation they call for.
+     *
+     * @return true if any event changed the state.
+     */
+    bool drain();
+
+    void run();
+};
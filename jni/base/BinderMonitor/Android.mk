@@ -7,12 +7,15 @@ LOCAL_MODULE := BinderMonitor
 LOCAL_SRC_FILES := $(wildcard $(LOCAL_PATH)/*.cpp)
 LOCAL_SRC_FILES := $(LOCAL_SRC_FILES:$(LOCAL_PATH)/%=%)
 
-LOCAL_STATIC_LIBRARIES := BinderNDK spdlog
+LOCAL_STATIC_LIBRARIES := BinderNDK DeviceInfo spdlog
 
 LOCAL_C_INCLUDES := $(ROOT_PATH)/include
 
 LOCAL_EXPORT_C_INCLUDES := $(LOCAL_PATH)
 
+# DexResolver inflates compressed DEX entries of framework jars
+LOCAL_EXPORT_LDLIBS := -lz
+
 LOCAL_CPPFLAGS += -fexceptions -std=c++23 -O2
 LOCAL_CPPFLAGS += -Wpedantic -Wall -Wextra -Werror -Wformat -Wuninitialized
 
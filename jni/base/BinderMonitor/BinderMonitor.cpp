@@ -16,18 +16,29 @@
 
 #include "BinderMonitor.hpp"
 #include "BinderNDK.hpp"
+#include "DeviceInfo.hpp"
+#include "DexResolver.hpp"
 #include "Encore.hpp"
 #include "EncoreLog.hpp"
 
+#include <android/api-level.h>
+#include <array>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <unistd.h>
 #include <sys/wait.h>
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
 
 // =============================================================================
 // Transaction Codes Enum & Resolver Metadata
@@ -44,7 +55,10 @@ enum class TxCode {
     OnProcessDied,
     OnProcessStarted,
     OnDisplayEvent,
-    GetPackageNameForUid
+    GetPackageNameForUid,
+    RegisterContentObserver,
+    SetInterruptionFilter,
+    Count // Number of codes, keep last
 };
 
 struct ResolverQuery {
@@ -65,38 +79,90 @@ static const std::unordered_map<TxCode, ResolverQuery> kResolverQueries = {
         {TxCode::OnProcessStarted, {"android.app.IProcessObserver.Stub::TRANSACTION_onProcessStarted", false, 0}},
         {TxCode::OnDisplayEvent, {"android.hardware.display.IDisplayManagerCallback.Stub::TRANSACTION_onDisplayEvent", false, 1}},
         {TxCode::GetPackageNameForUid, { "android.content.pm.IPackageManager.Stub::TRANSACTION_getNameForUid", true, 0}},
+        {TxCode::RegisterContentObserver, {"android.content.IContentService.Stub::TRANSACTION_registerContentObserver", false, 0}},
+        {TxCode::SetInterruptionFilter, {"android.app.INotificationManager.Stub::TRANSACTION_setInterruptionFilter", false, 0}},
 };
 
+// DisplayManagerGlobal event types, releases keep appending new ones
+static constexpr int32_t kDisplayEventAdded = 1;
+static constexpr int32_t kDisplayEventChanged = 2;
+static constexpr int32_t kDisplayEventRemoved = 3;
+static constexpr int32_t kDefaultDisplay = 0; // Display.DEFAULT_DISPLAY
+
+// Battery Saver mirrors its state into Settings.Global.LOW_POWER_MODE on every toggle, manual or automatic
+static constexpr const char *kLowPowerModeUri = "content://settings/global/low_power";
+
+// NotificationManagerService persists every zen mode change into Settings.Global.ZEN_MODE
+static constexpr const char *kZenModeUri = "content://settings/global/zen_mode";
+
+// NotificationManager.INTERRUPTION_FILTER_*, the ones `cmd notification set_dnd` maps priority and off to
+static constexpr int32_t kInterruptionFilterAll = 1;
+static constexpr int32_t kInterruptionFilterPriority = 2;
+
 // =============================================================================
 // Internal state
 // =============================================================================
 
+struct UidCacheEntry {
+    std::string packageName;
+    int8_t isGame = -1; // -1 unknown, 0 no, 1 yes
+};
+
 struct BinderMonitorState {
-    AIBinder *powerBinder = nullptr;
-    AIBinder *notificationBinder = nullptr;
-    AIBinder *activityBinder = nullptr;
-    AIBinder *displayBinder = nullptr;
-    AIBinder *packageBinder = nullptr;
+    // Published by the startup threads once acquired, null until then
+    std::atomic<AIBinder *> powerBinder{nullptr};
+    std::atomic<AIBinder *> notificationBinder{nullptr};
+    std::atomic<AIBinder *> activityBinder{nullptr};
+    std::atomic<AIBinder *> displayBinder{nullptr};
+    std::atomic<AIBinder *> packageBinder{nullptr};
+    AIBinder *contentBinder = nullptr;
 
     // Held alive so the remote services keep strong refs to our callbacks.
-    AIBinder *processObserverBinder = nullptr;
-    AIBinder *displayCallbackBinder = nullptr;
+    // Published by their stage, a re-resolve retries registering them.
+    std::atomic<AIBinder *> processObserverBinder{nullptr};
+    std::atomic<AIBinder *> displayCallbackBinder{nullptr};
+    AIBinder *powerSaveObserverBinder = nullptr;
+    AIBinder *zenModeObserverBinder = nullptr;
 
-    std::unordered_map<TxCode, uint32_t> txCodes;
+    // Swapped in place when codes are re-resolved while binder threads use them
+    std::array<std::atomic<uint32_t>, static_cast<size_t>(TxCode::Count)> txCodes{};
+    std::atomic<bool> reresolveStarted{false}; // Once per run, a code that stays unknown won't resolve by retrying
+
+    // Registrations that failed, retried once the codes are re-resolved
+    std::mutex registrationMutex;
+    bool processObserverRegistered = false;
+    bool displayCallbackRegistered = false;
 
     ProcessObserverCallbacks processCallbacks;
     DisplayStateCallback displayCallback;
     PowerSaveCallback powerSaveCallback;
 
-    bool displayLastState = false;
-    bool powerSaveLastState = false;
+    bool displayLastState = false; // Default display only
+    std::unordered_set<int32_t> secondaryDisplays; // Display events are oneway, never handled concurrently
+    std::atomic<bool> powerSaveLastState{false};
+
+    // Served from cache once the ZEN_MODE observer keeps it current
+    std::atomic<int32_t> zenMode{-1};
+    std::atomic<bool> zenModeObserved{false};
 
+    // Only runs when the Battery Saver observer couldn't be registered
     std::thread powerSavePollThread;
     std::atomic<bool> stopPowerSavePolling{false};
 
+    // Foreground events hit the same few UIDs all day, resolve each of them once
+    std::mutex uidCacheMutex;
+    std::unordered_map<int32_t, UidCacheEntry> uidCache;
+    GameClassifier gameClassifier;
+
+    // Resolves once the process observer stage is attached, or failed to
+    std::shared_future<bool> coreStage;
+
     uint32_t getCode(TxCode code) const {
-        auto it = txCodes.find(code);
-        return it != txCodes.end() ? it->second : 0;
+        return txCodes[static_cast<size_t>(code)].load(std::memory_order_relaxed);
+    }
+
+    void setCode(TxCode code, uint32_t value) {
+        txCodes[static_cast<size_t>(code)].store(value, std::memory_order_relaxed);
     }
 };
 
@@ -106,6 +172,29 @@ static BinderMonitorState gState;
 // Runtime transaction code resolver
 // =============================================================================
 
+/**
+ * @brief Parses "<query> <code>" lines as printed by the resolver.
+ */
+static std::unordered_map<std::string, uint32_t> parseResolverOutput(const std::string &output) {
+    std::unordered_map<std::string, uint32_t> result;
+    std::istringstream ss(output);
+    std::string line;
+    while (std::getline(ss, line)) {
+        if (line.rfind("ERROR:", 0) == 0) {
+            LOGW_TAG("BinderMonitor", "Resolver: {}", line);
+            continue;
+        }
+        auto sp = line.rfind(' ');
+        if (sp == std::string::npos) continue;
+        try {
+            result[line.substr(0, sp)] = static_cast<uint32_t>(std::stoul(line.substr(sp + 1)));
+        } catch (...) {
+            LOGW_TAG("BinderMonitor", "Failed to parse resolver output line: {}", line);
+        }
+    }
+    return result;
+}
+
 static std::unordered_map<std::string, uint32_t> runResolver(const char *apkPath) {
     std::unordered_map<std::string, uint32_t> result;
     int stdinPipe[2], stdoutPipe[2];
@@ -167,22 +256,136 @@ static std::unordered_map<std::string, uint32_t> runResolver(const char *apkPath
         return result;
     }
 
-    std::istringstream ss(output);
-    std::string line;
-    while (std::getline(ss, line)) {
-        if (line.rfind("ERROR:", 0) == 0) {
-            LOGW_TAG("BinderMonitor", "Resolver: {}", line);
-            continue;
+    return parseResolverOutput(output);
+}
+
+// =============================================================================
+// Transaction code cache
+// =============================================================================
+
+/**
+ * @brief Loads the codes resolved for a build, cached as the fingerprint followed by resolver output lines.
+ *
+ * @return Code of every query, empty if the cache is missing, incomplete or of another build.
+ */
+static std::unordered_map<std::string, uint32_t> loadCodeCache(const std::string &fingerprint) {
+    std::ifstream file(BINDER_CODE_CACHE);
+    std::string cachedFingerprint;
+    if (!file.is_open() || !std::getline(file, cachedFingerprint)) return {};
+
+    if (cachedFingerprint != fingerprint) {
+        LOGI_TAG("BinderMonitor", "Build changed, discarding cached transaction codes");
+        return {};
+    }
+
+    auto codes = parseResolverOutput({std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()});
+    for (const auto &[code, q] : kResolverQueries) {
+        if (!codes.contains(q.query)) {
+            LOGI_TAG("BinderMonitor", "Cached transaction codes lack {}, discarding them", q.query);
+            return {};
         }
-        auto sp = line.rfind(' ');
-        if (sp == std::string::npos) continue;
-        try {
-            result[line.substr(0, sp)] = static_cast<uint32_t>(std::stoul(line.substr(sp + 1)));
-        } catch (...) {
-            LOGW_TAG("BinderMonitor", "Failed to parse resolver output line: {}", line);
+    }
+    return codes;
+}
+
+/**
+ * @brief Persists the codes of every query, unresolved ones as 0.
+ */
+static void saveCodeCache(const std::string &fingerprint, const std::unordered_map<std::string, uint32_t> &codes) {
+    const std::string tmpPath = std::string(BINDER_CODE_CACHE) + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::trunc);
+        if (!file.is_open()) {
+            LOGW_TAG("BinderMonitor", "Failed to write {}", tmpPath);
+            return;
+        }
+
+        file << fingerprint << '\n';
+        for (const auto &[code, q] : kResolverQueries) {
+            auto it = codes.find(q.query);
+            file << q.query << ' ' << (it != codes.end() ? it->second : 0) << '\n';
         }
     }
-    return result;
+
+    if (rename(tmpPath.c_str(), BINDER_CODE_CACHE) != 0) {
+        LOGW_TAG("BinderMonitor", "Failed to write {}: {}", BINDER_CODE_CACHE, strerror(errno));
+        unlink(tmpPath.c_str());
+        return;
+    }
+    LOGD_TAG("BinderMonitor", "Saved transaction codes to {}", BINDER_CODE_CACHE);
+}
+
+/**
+ * @brief Applies resolved codes, queries left unresolved keep their fallback.
+ *
+ * @return true if every required code is known.
+ */
+static bool applyCodes(const std::unordered_map<std::string, uint32_t> &codes) {
+    bool complete = true;
+    for (const auto &[code, q] : kResolverQueries) {
+        auto it = codes.find(q.query);
+        gState.setCode(code, it != codes.end() && it->second != 0 ? it->second : q.fallback);
+        if (q.isRequired && gState.getCode(code) == 0) {
+            LOGE_TAG("BinderMonitor", "Failed to resolve required transaction code: {}", q.query);
+            complete = false;
+        }
+    }
+    return complete;
+}
+
+/**
+ * @brief Resolves every code, from the framework DEX and, for required codes it lacks, the resolver APK.
+ */
+static std::unordered_map<std::string, uint32_t> resolveCodes() {
+    std::vector<std::string> queries;
+    for (const auto &[code, q] : kResolverQueries) {
+        queries.emplace_back(q.query);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto codes = DexResolver::resolve(queries);
+    LOGI_TAG("BinderMonitor", "Resolved {}/{} transaction codes from framework DEX in {} ms", codes.size(), queries.size(),
+             std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+
+    // Stripped framework jars only ship their DEX inside the boot image, which only ART can read
+    for (const auto &[code, q] : kResolverQueries) {
+        if (!q.isRequired || codes.contains(q.query)) continue;
+
+        LOGW_TAG("BinderMonitor", "{} not found in framework DEX, falling back to resolver APK", q.query);
+        codes.merge(runResolver(MODPATH "/binder_resolver.apk"));
+        break;
+    }
+
+    return codes;
+}
+
+static void retryFailedRegistrations();
+
+/**
+ * @brief Re-resolves every code in the background after a service rejected one as unknown.
+ *
+ * Cached codes may go stale without a fingerprint change, e.g. through a mainline update.
+ * This runs at most once per daemon run, registrations that failed on the stale codes are
+ * retried afterwards.
+ */
+static void scheduleReresolve() {
+    if (gState.reresolveStarted.exchange(true)) {
+        LOGD_TAG("BinderMonitor", "Unknown transaction code, codes were already re-resolved this boot");
+        return;
+    }
+
+    LOGW_TAG("BinderMonitor", "Unknown transaction code, re-resolving transaction codes in background");
+    std::thread([]() {
+        auto codes = resolveCodes();
+        if (codes.empty() || !applyCodes(codes)) {
+            LOGE_TAG("BinderMonitor", "Failed to re-resolve transaction codes");
+            return;
+        }
+
+        saveCodeCache(DeviceInfo::get_build_fingerprint(), codes);
+        LOGI_TAG("BinderMonitor", "Transaction codes re-resolved");
+        retryFailedRegistrations();
+    }).detach();
 }
 
 // =============================================================================
@@ -219,6 +422,7 @@ static int32_t transactReadInt32(AIBinder *binder, uint32_t tx, const char *ifTo
     binder_status_t status = AIBinder_transact(binder, tx, &in, &out, 0);
     if (status != STATUS_OK) {
         LOGE_TAG("BinderMonitor", "transact failed for tx={} iface={} status={}", tx, ifToken, status);
+        if (status == STATUS_UNKNOWN_TRANSACTION) scheduleReresolve();
         if (out) AParcel_delete(out);
         return onError;
     }
@@ -260,6 +464,7 @@ static std::string transactReadString(AIBinder *binder, uint32_t tx, const char
 
     if (status != STATUS_OK) {
         LOGE_TAG("BinderMonitor", "transact failed for tx={} iface={} status={}", tx, ifToken, status);
+        if (status == STATUS_UNKNOWN_TRANSACTION) scheduleReresolve();
         if (out) AParcel_delete(out);
         return onError;
     }
@@ -286,6 +491,37 @@ static std::string transactReadString(AIBinder *binder, uint32_t tx, const char
     return value;
 }
 
+/**
+ * @brief Writes a string the way Parcel::writeString8() does: length, then the bytes
+ *        including the terminating NUL padded to four bytes.
+ */
+static void writeString8(AParcel *parcel, const std::string &value) {
+    AParcel_writeInt32(parcel, static_cast<int32_t>(value.size()));
+
+    std::string padded = value;
+    padded.resize((value.size() + 1 + 3) & ~static_cast<size_t>(3), '\0');
+    for (size_t i = 0; i < padded.size(); i += sizeof(int32_t)) {
+        int32_t word;
+        memcpy(&word, padded.data() + i, sizeof(word));
+        AParcel_writeInt32(parcel, word);
+    }
+}
+
+/**
+ * @brief Writes a non-null android.net.Uri parcelable.
+ */
+static void writeUri(AParcel *parcel, const std::string &uri) {
+    AParcel_writeInt32(parcel, 1); // Non-null parcelable
+    AParcel_writeInt32(parcel, 1); // Uri.StringUri.TYPE_ID
+
+    // Android 12 switched Uri parceling from UTF-16 to UTF-8 strings
+    if (android_get_device_api_level() >= 31) {
+        writeString8(parcel, uri);
+    } else {
+        AParcel_writeString(parcel, uri.c_str(), static_cast<int32_t>(uri.size()));
+    }
+}
+
 /**
  * @brief Waits for a service to register.
  */
@@ -363,8 +599,30 @@ static binder_status_t processObserver_transact(AIBinder *, uint32_t code,
 }
 
 static binder_status_t
-displayCallback_transact(AIBinder *, uint32_t code, const AParcel *, AParcel *) {
+displayCallback_transact(AIBinder *, uint32_t code, const AParcel *in, AParcel *) {
     if (code != gState.getCode(TxCode::OnDisplayEvent)) return STATUS_UNKNOWN_ERROR;
+
+    // onDisplayEvent(int displayId, int event)
+    int32_t displayId = -1, event = 0;
+    if (AParcel_readInt32(in, &displayId) != STATUS_OK || AParcel_readInt32(in, &event) != STATUS_OK) {
+        LOGW_TAG("BinderMonitor", "Malformed onDisplayEvent parcel");
+        return STATUS_OK;
+    }
+
+    // Secondary displays (external, cover or inner panels of foldables) come and go on their
+    // own, only the default display tells whether the device is in use
+    if (displayId != kDefaultDisplay) {
+        if (event == kDisplayEventAdded && gState.secondaryDisplays.insert(displayId).second) {
+            LOGD_TAG("BinderMonitor", "Display {} added, ignoring its events", displayId);
+        } else if (event == kDisplayEventRemoved && gState.secondaryDisplays.erase(displayId)) {
+            LOGD_TAG("BinderMonitor", "Display {} removed", displayId);
+        }
+        return STATUS_OK;
+    }
+
+    // Brightness, HDR ratio and connection events never carry a power state change
+    if (event != kDisplayEventChanged && event != kDisplayEventAdded) return STATUS_OK;
+
     bool current = queryIsInteractive();
     if (current != gState.displayLastState) {
         gState.displayLastState = current;
@@ -373,103 +631,229 @@ displayCallback_transact(AIBinder *, uint32_t code, const AParcel *, AParcel *)
     return STATUS_OK;
 }
 
+static void refreshPowerSave() {
+    bool current = transactReadInt32(gState.powerBinder, gState.getCode(TxCode::IsPowerSaveMode), "android.os.IPowerManager", 0) != 0;
+    if (gState.powerSaveLastState.exchange(current) != current && gState.powerSaveCallback) {
+        gState.powerSaveCallback(current);
+    }
+}
+
+static binder_status_t powerSaveObserver_transact(AIBinder *, uint32_t, const AParcel *, AParcel *) {
+    // onChange() signatures differ between releases, any notification just means the setting changed
+    refreshPowerSave();
+    return STATUS_OK;
+}
+
 static void pollPowerSave() {
     while (!gState.stopPowerSavePolling) {
-        bool current = transactReadInt32(gState.powerBinder, gState.getCode(TxCode::IsPowerSaveMode), "android.os.IPowerManager", 0) != 0;
-        if (current != gState.powerSaveLastState) {
-            gState.powerSaveLastState = current;
-            if (gState.powerSaveCallback) {
-                gState.powerSaveCallback(current);
-            }
-        }
+        refreshPowerSave();
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
 }
 
-// =============================================================================
-// BinderMonitor
-// =============================================================================
+/**
+ * @brief Acquires the settings content service, shared by every settings observer.
+ */
+static AIBinder *acquireContentService() {
+    static std::once_flag once;
+    std::call_once(once, []() {
+        AIBinder *binder = AServiceManager_getService("content");
+        if (!binder) {
+            LOGW_TAG("BinderMonitor", "Service 'content' not available");
+            return;
+        }
 
-BinderMonitor &BinderMonitor::get() {
-    static BinderMonitor instance;
-    return instance;
+        AIBinder_Class *csClazz = AIBinder_Class_define(
+                "android.content.IContentService", noopCreate, noopDestroy, noopTransact);
+        AIBinder_associateClass(binder, csClazz);
+        gState.contentBinder = binder;
+    });
+    return gState.contentBinder;
 }
 
-BinderMonitor::~BinderMonitor() {
-    gState.stopPowerSavePolling = true;
-    if (gState.powerSavePollThread.joinable()) {
-        gState.powerSavePollThread.join();
+/**
+ * @brief Registers a content observer notified whenever a setting changes.
+ *
+ * @param uri Setting URI, e.g. content://settings/global/low_power.
+ * @param onChange Transaction handler of the observer.
+ * @param observer Receives the observer binder, kept alive for as long as it is registered.
+ * @return true if the observer was registered.
+ */
+static bool registerSettingsObserver(const char *uri, AIBinder_Class_onTransact onChange, AIBinder *&observer) {
+    uint32_t tx = gState.getCode(TxCode::RegisterContentObserver);
+    if (!tx) {
+        LOGW_TAG("BinderMonitor", "TRANSACTION_registerContentObserver not resolved");
+        return false;
     }
-}
 
-bool BinderMonitor::initialize() {
-    // Initialize fallbacks
-    for (const auto &[code, q] : kResolverQueries) {
-        gState.txCodes[code] = q.fallback;
+    AIBinder *contentBinder = acquireContentService();
+    if (!contentBinder) return false;
+
+    AIBinder_Class *observerClazz = AIBinder_Class_define(
+            "android.database.IContentObserver", noopCreate, noopDestroy, onChange);
+    observer = AIBinder_new(observerClazz, nullptr);
+    if (!observer) {
+        LOGE_TAG("BinderMonitor", "Failed to allocate IContentObserver binder");
+        return false;
     }
 
-    LOGI_TAG("BinderMonitor", "Resolving transaction codes...");
-    auto codes = runResolver(MODPATH "/binder_resolver.apk");
-    for (const auto &[code, q] : kResolverQueries) {
-        auto it = codes.find(q.query);
-        if (it != codes.end()) {
-            gState.txCodes[code] = it->second;
-        }
-        if (q.isRequired && gState.txCodes[code] == 0) {
-            LOGE_TAG("BinderMonitor", "Failed to resolve required transaction code: {}", q.query);
-            return false;
-        }
+    AParcel *in = nullptr, *out = nullptr;
+    if (AIBinder_prepareTransaction(contentBinder, &in) != STATUS_OK) {
+        LOGE_TAG("BinderMonitor", "prepareTransaction failed for registerContentObserver");
+        return false;
     }
 
-    if (gState.getCode(TxCode::OnProcessStarted) == 0) {
-        LOGW_TAG("BinderMonitor", "TRANSACTION_onProcessStarted not resolved, onProcessStarted callback disabled");
+    AParcel_writeInterfaceToken(in, "android.content.IContentService");
+    writeUri(in, uri);
+    AParcel_writeBool(in, false); // notifyForDescendants
+    AParcel_writeStrongBinder(in, observer);
+    AParcel_writeInt32(in, 0); // USER_SYSTEM, global settings notify every user
+    AParcel_writeInt32(in, android_get_device_api_level()); // targetSdkVersion
+
+    binder_status_t status = AIBinder_transact(contentBinder, tx, &in, &out, 0);
+    if (status != STATUS_OK) {
+        LOGE_TAG("BinderMonitor", "registerContentObserver transaction failed, status={}", status);
+        if (status == STATUS_UNKNOWN_TRANSACTION) scheduleReresolve();
+        if (out) AParcel_delete(out);
+        return false;
     }
-    LOGI_TAG("BinderMonitor", "All required transaction codes resolved");
-
-    struct {
-        const char *name;
-        AIBinder **out;
-    } services[] = {
-            {"power",        &gState.powerBinder},
-            {"notification", &gState.notificationBinder},
-            {"activity",     &gState.activityBinder},
-            {"display",      &gState.displayBinder},
-            {"package",      &gState.packageBinder},
-    };
-
-    for (auto &s: services) {
-        *s.out = AServiceManager_getService(s.name);
-        if (!*s.out) {
-            LOGW_TAG("BinderMonitor", "Service '{}' not immediately available, waiting...", s.name);
-            *s.out = waitForServiceCompat(s.name);
-        }
-        if (!*s.out) {
-            LOGE_TAG("BinderMonitor", "Failed to acquire service '{}'", s.name);
-            return false;
+
+    AStatus *st = nullptr;
+    AParcel_readStatusHeader(out, &st);
+    bool ok = st && AStatus_isOk(st);
+    if (!ok) {
+        const char *desc = st ? AStatus_getDescription(st) : "null status";
+        LOGE_TAG("BinderMonitor", "registerContentObserver rejected for {}: {}", uri, desc);
+        if (st) {
+            AStatus_deleteDescription(desc);
+            AStatus_delete(st);
         }
-        LOGD_TAG("BinderMonitor", "Acquired service '{}'", s.name);
+        AParcel_delete(out);
+        return false;
     }
+    if (st) AStatus_delete(st);
+    AParcel_delete(out);
+
+    LOGI_TAG("BinderMonitor", "Observer for {} registered successfully", uri);
+    return true;
+}
+
+static void refreshZenMode() {
+    int32_t zenMode = transactReadInt32(gState.notificationBinder, gState.getCode(TxCode::GetZenMode), "android.app.INotificationManager");
+    if (zenMode >= 0) gState.zenMode = zenMode;
+}
+
+static binder_status_t zenModeObserver_transact(AIBinder *, uint32_t, const AParcel *, AParcel *) {
+    refreshZenMode();
+    return STATUS_OK;
+}
+
+// =============================================================================
+// Staged startup
+// =============================================================================
+
+using StartupClock = std::chrono::steady_clock;
+
+static long long msSince(StartupClock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(StartupClock::now() - start).count();
+}
+
+/**
+ * @brief Acquires a service on its own thread, waiting for it to register if needed.
+ *
+ * @param out Receives the binder once its interface is associated.
+ * @return Future of the binder, nullptr if the service never showed up.
+ */
+static std::shared_future<AIBinder *> acquireServiceAsync(
+        const char *name, const char *descriptor, std::atomic<AIBinder *> &out, StartupClock::time_point start) {
+    auto promise = std::make_shared<std::promise<AIBinder *>>();
+    auto future = promise->get_future().share();
+
+    std::thread([promise, name, descriptor, &out, start]() {
+        AIBinder *binder = AServiceManager_getService(name);
+        if (!binder) {
+            LOGW_TAG("BinderMonitor", "Service '{}' not immediately available, waiting...", name);
+            binder = waitForServiceCompat(name);
+        }
+
+        if (binder) {
+            AIBinder_Class *clazz = AIBinder_Class_define(descriptor, noopCreate, noopDestroy, noopTransact);
+            AIBinder_associateClass(binder, clazz);
+            out = binder;
+            LOGD_TAG("BinderMonitor", "Acquired service '{}' after {} ms", name, msSince(start));
+        } else {
+            LOGE_TAG("BinderMonitor", "Failed to acquire service '{}'", name);
+        }
+        promise->set_value(binder);
+    }).detach();
+
+    return future;
+}
+
+/**
+ * @brief Attaches a feature on its own thread once every service it needs is acquired.
+ *
+ * @return Future of the attach result, false if a service is missing.
+ */
+static std::shared_future<bool> runStage(
+        const char *stage, std::vector<std::shared_future<AIBinder *>> services, bool (*attach)(),
+        StartupClock::time_point start) {
+    auto promise = std::make_shared<std::promise<bool>>();
+    auto future = promise->get_future().share();
+
+    std::thread([promise, stage, services = std::move(services), attach, start]() {
+        bool ok = true;
+        for (const auto &service : services) {
+            if (!service.get()) ok = false;
+        }
+
+        if (!ok) {
+            LOGE_TAG("BinderMonitor", "Stage '{}' unavailable, its services are missing", stage);
+        } else if ((ok = attach())) {
+            LOGI_TAG("BinderMonitor", "Stage '{}' attached after {} ms", stage, msSince(start));
+        }
+        promise->set_value(ok);
+    }).detach();
+
+    return future;
+}
 
-    AIBinder_Class *powerClazz = AIBinder_Class_define(
-            "android.os.IPowerManager", noopCreate, noopDestroy, noopTransact);
-    AIBinder_associateClass(gState.powerBinder, powerClazz);
+/**
+ * @brief Registers the allocated IProcessObserver with the activity manager.
+ *
+ * @return true if registered now or before.
+ */
+static bool registerProcessObserver() {
+    std::lock_guard<std::mutex> lock(gState.registrationMutex);
+    if (gState.processObserverRegistered) return true;
 
-    AIBinder_Class *nmClazz = AIBinder_Class_define(
-            "android.app.INotificationManager", noopCreate, noopDestroy, noopTransact);
-    AIBinder_associateClass(gState.notificationBinder, nmClazz);
+    AParcel *in = nullptr, *out = nullptr;
+    if (AIBinder_prepareTransaction(gState.activityBinder, &in) != STATUS_OK) {
+        LOGE_TAG("BinderMonitor", "prepareTransaction failed for registerProcessObserver");
+        return false;
+    }
 
-    AIBinder_Class *amClazz = AIBinder_Class_define(
-            "android.app.IActivityManager", noopCreate, noopDestroy, noopTransact);
-    AIBinder_associateClass(gState.activityBinder, amClazz);
+    AParcel_writeInterfaceToken(in, "android.app.IActivityManager");
+    AParcel_writeStrongBinder(in, gState.processObserverBinder);
+    binder_status_t status = AIBinder_transact(
+            gState.activityBinder, gState.getCode(TxCode::RegisterProcessObserver), &in, &out, 0);
+    if (out) AParcel_delete(out);
 
-    AIBinder_Class *dmClazz = AIBinder_Class_define(
-            "android.hardware.display.IDisplayManager", noopCreate, noopDestroy, noopTransact);
-    AIBinder_associateClass(gState.displayBinder, dmClazz);
+    if (status != STATUS_OK) {
+        LOGE_TAG("BinderMonitor", "registerProcessObserver transaction failed, status={}", status);
+        if (status == STATUS_UNKNOWN_TRANSACTION) scheduleReresolve();
+        return false;
+    }
 
-    AIBinder_Class *pmClazz = AIBinder_Class_define(
-            "android.content.pm.IPackageManager", noopCreate, noopDestroy, noopTransact);
-    AIBinder_associateClass(gState.packageBinder, pmClazz);
+    LOGI_TAG("BinderMonitor", "Process observer registered successfully");
+    gState.processObserverRegistered = true;
+    return true;
+}
 
+/**
+ * @brief Registers the IProcessObserver, needs activity and package.
+ */
+static bool attachProcessObserver() {
     AIBinder_Class *processObserverClazz = AIBinder_Class_define(
             "android.app.IProcessObserver", noopCreate, noopDestroy, processObserver_transact);
     gState.processObserverBinder = AIBinder_new(processObserverClazz, nullptr);
@@ -479,24 +863,51 @@ bool BinderMonitor::initialize() {
         return false;
     }
 
-    {
-        AParcel *in = nullptr, *out = nullptr;
-        if (AIBinder_prepareTransaction(gState.activityBinder, &in) == STATUS_OK) {
-            AParcel_writeInterfaceToken(in, "android.app.IActivityManager");
-            AParcel_writeStrongBinder(in, gState.processObserverBinder);
-            binder_status_t status = AIBinder_transact(
-                    gState.activityBinder, gState.getCode(TxCode::RegisterProcessObserver), &in, &out, 0);
-            if (status != STATUS_OK) {
-                LOGE_TAG("BinderMonitor", "registerProcessObserver transaction failed, status={}", status);
-            } else {
-                LOGI_TAG("BinderMonitor", "Process observer registered successfully");
-            }
-            if (out) AParcel_delete(out);
-        } else {
-            LOGE_TAG("BinderMonitor", "prepareTransaction failed for registerProcessObserver");
-        }
+    registerProcessObserver();
+    return true;
+}
+
+/**
+ * @brief Registers the allocated IDisplayManagerCallback with the display manager.
+ *
+ * @return true if registered now or before.
+ */
+static bool registerDisplayCallback() {
+    std::lock_guard<std::mutex> lock(gState.registrationMutex);
+    if (gState.displayCallbackRegistered) return true;
+
+    AParcel *in = nullptr, *out = nullptr;
+    if (AIBinder_prepareTransaction(gState.displayBinder, &in) != STATUS_OK) {
+        LOGE_TAG("BinderMonitor", "prepareTransaction failed for registerCallback (display)");
+        return false;
     }
 
+    AParcel_writeInterfaceToken(in, "android.hardware.display.IDisplayManager");
+    AParcel_writeStrongBinder(in, gState.displayCallbackBinder);
+    binder_status_t status = AIBinder_transact(
+            gState.displayBinder,
+            gState.getCode(TxCode::RegisterDisplayCallback),
+            &in,
+            &out,
+            0
+    );
+    if (out) AParcel_delete(out);
+
+    if (status != STATUS_OK) {
+        LOGE_TAG("BinderMonitor", "registerCallback (display) transaction failed, status={}", status);
+        if (status == STATUS_UNKNOWN_TRANSACTION) scheduleReresolve();
+        return false;
+    }
+
+    LOGI_TAG("BinderMonitor", "Display callback registered successfully");
+    gState.displayCallbackRegistered = true;
+    return true;
+}
+
+/**
+ * @brief Reports the initial screen state and registers the IDisplayManagerCallback, needs display and power.
+ */
+static bool attachDisplayCallback() {
     AIBinder_Class *displayCallbackClazz = AIBinder_Class_define(
             "android.hardware.display.IDisplayManagerCallback",
             noopCreate, noopDestroy, displayCallback_transact);
@@ -509,43 +920,115 @@ bool BinderMonitor::initialize() {
     gState.displayLastState = queryIsInteractive();
     if (gState.displayCallback) gState.displayCallback(gState.displayLastState);
 
-    {
-        AParcel *in = nullptr, *out = nullptr;
-        if (AIBinder_prepareTransaction(gState.displayBinder, &in) == STATUS_OK) {
-            AParcel_writeInterfaceToken(in, "android.hardware.display.IDisplayManager");
-            AParcel_writeStrongBinder(in, gState.displayCallbackBinder);
-            binder_status_t status = AIBinder_transact(
-                    gState.displayBinder,
-                    gState.getCode(TxCode::RegisterDisplayCallback),
-                    &in,
-                    &out,
-                    0
-            );
-            if (status != STATUS_OK) {
-                LOGE_TAG("BinderMonitor", "registerCallback (display) transaction failed, status={}", status);
-            } else {
-                LOGI_TAG("BinderMonitor", "Display callback registered successfully");
-            }
-            if (out) AParcel_delete(out);
-        } else {
-            LOGE_TAG("BinderMonitor", "prepareTransaction failed for registerCallback (display)");
-        }
-    }
+    registerDisplayCallback();
+    return true;
+}
+
+/**
+ * @brief Registers again whatever failed on the codes that were just replaced.
+ *
+ * Stages that haven't attached yet are skipped, they register with the new codes themselves.
+ */
+static void retryFailedRegistrations() {
+    if (gState.processObserverBinder) registerProcessObserver();
+    if (gState.displayCallbackBinder) registerDisplayCallback();
+}
 
-    // Initialize Power Save state and start polling thread
+/**
+ * @brief Reports the initial Battery Saver state and follows it through the observer or, failing that, by polling.
+ */
+static bool attachPowerSave() {
     gState.powerSaveLastState = transactReadInt32(gState.powerBinder, gState.getCode(TxCode::IsPowerSaveMode), "android.os.IPowerManager", 0) != 0;
     if (gState.powerSaveCallback) {
         gState.powerSaveCallback(gState.powerSaveLastState);
     }
 
-    gState.stopPowerSavePolling = false;
-    gState.powerSavePollThread = std::thread(pollPowerSave);
+    if (!registerSettingsObserver(kLowPowerModeUri, powerSaveObserver_transact, gState.powerSaveObserverBinder)) {
+        LOGW_TAG("BinderMonitor", "Falling back to polling Battery Saver state");
+        gState.stopPowerSavePolling = false;
+        gState.powerSavePollThread = std::thread(pollPowerSave);
+    }
+    return true;
+}
 
+/**
+ * @brief Caches zen mode and keeps it current through an observer on ZEN_MODE.
+ */
+static bool attachZenMode() {
+    // Registered before reading, a change in between still reaches the observer
+    if (registerSettingsObserver(kZenModeUri, zenModeObserver_transact, gState.zenModeObserverBinder)) {
+        refreshZenMode();
+        gState.zenModeObserved = true;
+    } else {
+        LOGW_TAG("BinderMonitor", "Falling back to querying zen mode on demand");
+    }
+    return true;
+}
+
+// =============================================================================
+// BinderMonitor
+// =============================================================================
+
+BinderMonitor &BinderMonitor::get() {
+    static BinderMonitor instance;
+    return instance;
+}
+
+BinderMonitor::~BinderMonitor() {
+    gState.stopPowerSavePolling = true;
+    if (gState.powerSavePollThread.joinable()) {
+        gState.powerSavePollThread.join();
+    }
+}
+
+bool BinderMonitor::initialize() {
+    const auto start = StartupClock::now();
+
+    // Codes only change with the build, resolving them means scanning the whole framework DEX
+    const std::string &fingerprint = DeviceInfo::get_build_fingerprint();
+    auto codes = loadCodeCache(fingerprint);
+    if (!codes.empty() && applyCodes(codes)) {
+        LOGI_TAG("BinderMonitor", "Loaded transaction codes from {}", BINDER_CODE_CACHE);
+    } else {
+        LOGI_TAG("BinderMonitor", "Resolving transaction codes...");
+        codes = resolveCodes();
+        if (!applyCodes(codes)) return false;
+        saveCodeCache(fingerprint, codes);
+    }
+
+    if (gState.getCode(TxCode::OnProcessStarted) == 0) {
+        LOGW_TAG("BinderMonitor", "TRANSACTION_onProcessStarted not resolved, onProcessStarted callback disabled");
+    }
+    LOGI_TAG("BinderMonitor", "All required transaction codes resolved after {} ms", msSince(start));
+
+    // Incoming callbacks are served as soon as the stages below register them
     ABinderProcess_startThreadPool();
+
+    // Services register independently of each other, wait for all of them at once and bring
+    // every feature up as soon as the services it needs appear
+    auto power = acquireServiceAsync("power", "android.os.IPowerManager", gState.powerBinder, start);
+    auto notification = acquireServiceAsync("notification", "android.app.INotificationManager", gState.notificationBinder, start);
+    auto activity = acquireServiceAsync("activity", "android.app.IActivityManager", gState.activityBinder, start);
+    auto display = acquireServiceAsync("display", "android.hardware.display.IDisplayManager", gState.displayBinder, start);
+    auto package = acquireServiceAsync("package", "android.content.pm.IPackageManager", gState.packageBinder, start);
+
+    gState.coreStage = runStage("process observer", {activity, package}, attachProcessObserver, start);
+    runStage("display", {display, power}, attachDisplayCallback, start);
+    runStage("battery saver", {power}, attachPowerSave, start);
+    runStage("zen mode", {notification}, attachZenMode, start);
+
     LOGI_TAG("BinderMonitor", "BinderMonitor initialized");
     return true;
 }
 
+bool BinderMonitor::waitForCoreServices() {
+    if (!gState.coreStage.valid()) {
+        LOGE_TAG("BinderMonitor", "waitForCoreServices called before successful initialize()");
+        return false;
+    }
+    return gState.coreStage.get();
+}
+
 void BinderMonitor::setProcessObserverCallbacks(ProcessObserverCallbacks callbacks) {
     gState.processCallbacks = std::move(callbacks);
 }
@@ -560,7 +1043,7 @@ void BinderMonitor::setPowerSaveCallback(PowerSaveCallback callback) {
 
 bool BinderMonitor::isPowerSave() {
     if (!gState.powerBinder) {
-        LOGE_TAG("BinderMonitor", "isPowerSave called before successful initialize()");
+        LOGW_TAG("BinderMonitor", "isPowerSave called before service 'power' was acquired");
         return false;
     }
     uint32_t tx = gState.getCode(TxCode::IsPowerSaveMode);
@@ -570,22 +1053,150 @@ bool BinderMonitor::isPowerSave() {
 
 int32_t BinderMonitor::getZenMode() {
     if (!gState.notificationBinder) {
-        LOGE_TAG("BinderMonitor", "getZenMode called before successful initialize()");
+        LOGW_TAG("BinderMonitor", "getZenMode called before service 'notification' was acquired");
         return -1;
     }
+    if (gState.zenModeObserved) return gState.zenMode;
+
     uint32_t tx = gState.getCode(TxCode::GetZenMode);
     if (!tx) return -1;
     return transactReadInt32(gState.notificationBinder, tx, "android.app.INotificationManager");
 }
 
+bool BinderMonitor::setDoNotDisturb(bool enabled) {
+    uint32_t tx = gState.getCode(TxCode::SetInterruptionFilter);
+    if (!tx || !gState.notificationBinder) return false;
+
+    AParcel *in = nullptr, *out = nullptr;
+    if (AIBinder_prepareTransaction(gState.notificationBinder, &in) != STATUS_OK) {
+        LOGE_TAG("BinderMonitor", "prepareTransaction failed for setInterruptionFilter");
+        return false;
+    }
+
+    // Attributed to the shell like `cmd notification set_dnd`, root passes the policy access check
+    const char *pkg = "com.android.shell";
+    AParcel_writeInterfaceToken(in, "android.app.INotificationManager");
+    AParcel_writeString(in, pkg, static_cast<int32_t>(strlen(pkg)));
+    AParcel_writeInt32(in, enabled ? kInterruptionFilterPriority : kInterruptionFilterAll);
+    AParcel_writeBool(in, true); // fromUser, Android 15+, trailing data is ignored before
+
+    binder_status_t status = AIBinder_transact(gState.notificationBinder, tx, &in, &out, 0);
+    if (status != STATUS_OK) {
+        LOGE_TAG("BinderMonitor", "setInterruptionFilter transaction failed, status={}", status);
+        if (status == STATUS_UNKNOWN_TRANSACTION) scheduleReresolve();
+        if (out) AParcel_delete(out);
+        return false;
+    }
+
+    AStatus *st = nullptr;
+    AParcel_readStatusHeader(out, &st);
+    bool ok = st && AStatus_isOk(st);
+    if (!ok) {
+        const char *desc = st ? AStatus_getDescription(st) : "null status";
+        LOGE_TAG("BinderMonitor", "setInterruptionFilter rejected: {}", desc);
+        if (st) AStatus_deleteDescription(desc);
+    }
+    if (st) AStatus_delete(st);
+    AParcel_delete(out);
+
+    // The observer only catches up once the setting is written, don't serve the old mode until then
+    if (ok && gState.zenModeObserved) refreshZenMode();
+    return ok;
+}
+
 std::string BinderMonitor::getPackageNameForUid(int32_t uid) {
+    {
+        std::lock_guard<std::mutex> lock(gState.uidCacheMutex);
+        auto it = gState.uidCache.find(uid);
+        if (it != gState.uidCache.end()) return it->second.packageName;
+    }
+
     if (!gState.packageBinder) {
-        LOGE_TAG("BinderMonitor", "getPackageNameForUid called before successful initialize()");
+        LOGW_TAG("BinderMonitor", "getPackageNameForUid called before service 'package' was acquired");
         return "";
     }
     uint32_t tx = gState.getCode(TxCode::GetPackageNameForUid);
     if (!tx) return "";
-    return transactReadString(gState.packageBinder, tx, "android.content.pm.IPackageManager", uid);
+
+    std::string packageName = transactReadString(gState.packageBinder, tx, "android.content.pm.IPackageManager", uid);
+    if (auto nullPos = packageName.find('\0'); nullPos != std::string::npos) {
+        packageName.resize(nullPos);
+    }
+
+    // Failed lookups are retried next time
+    if (!packageName.empty()) {
+        std::lock_guard<std::mutex> lock(gState.uidCacheMutex);
+        gState.uidCache[uid].packageName = packageName;
+    }
+    return packageName;
+}
+
+void BinderMonitor::setGameClassifier(GameClassifier classifier) {
+    std::lock_guard<std::mutex> lock(gState.uidCacheMutex);
+    gState.gameClassifier = std::move(classifier);
+    for (auto &[uid, entry] : gState.uidCache) {
+        entry.isGame = -1;
+    }
+}
+
+bool BinderMonitor::isGameUid(int32_t uid, std::string *packageName) {
+    {
+        std::lock_guard<std::mutex> lock(gState.uidCacheMutex);
+        auto it = gState.uidCache.find(uid);
+        if (it != gState.uidCache.end() && it->second.isGame >= 0) {
+            if (it->second.isGame && packageName) *packageName = it->second.packageName;
+            return it->second.isGame;
+        }
+    }
+
+    std::string name = getPackageNameForUid(uid);
+    if (name.empty()) return false;
+
+    std::lock_guard<std::mutex> lock(gState.uidCacheMutex);
+    const bool isGame = gState.gameClassifier && gState.gameClassifier(name);
+
+    // The cache may have been invalidated during the lookup, only record the flag for a current entry
+    auto it = gState.uidCache.find(uid);
+    if (it != gState.uidCache.end() && it->second.packageName == name) {
+        it->second.isGame = isGame ? 1 : 0;
+    }
+
+    if (isGame && packageName) *packageName = std::move(name);
+    return isGame;
+}
+
+void BinderMonitor::primeUidCache(const std::unordered_map<std::string, uid_t> &packages) {
+    std::unordered_map<int32_t, const std::string *> names;
+    std::unordered_set<int32_t> shared;
+    names.reserve(packages.size());
+    for (const auto &[packageName, uid] : packages) {
+        const int32_t key = static_cast<int32_t>(uid);
+        if (!names.emplace(key, &packageName).second) shared.insert(key);
+    }
+
+    std::lock_guard<std::mutex> lock(gState.uidCacheMutex);
+    for (const auto &[uid, packageName] : names) {
+        if (shared.contains(uid)) continue;
+
+        UidCacheEntry &entry = gState.uidCache[uid];
+        entry.packageName = *packageName;
+        entry.isGame = -1;
+        if (gState.gameClassifier) entry.isGame = gState.gameClassifier(*packageName) ? 1 : 0;
+    }
+    LOGD_TAG("BinderMonitor", "Primed {} UIDs from the package list", names.size() - shared.size());
+}
+
+void BinderMonitor::invalidatePackageCache() {
+    std::lock_guard<std::mutex> lock(gState.uidCacheMutex);
+    LOGD_TAG("BinderMonitor", "Dropping {} cached UIDs", gState.uidCache.size());
+    gState.uidCache.clear();
+}
+
+void BinderMonitor::invalidateGameCache() {
+    std::lock_guard<std::mutex> lock(gState.uidCacheMutex);
+    for (auto &[uid, entry] : gState.uidCache) {
+        entry.isGame = -1;
+    }
 }
 
 void BinderMonitor::joinThreadPool() {
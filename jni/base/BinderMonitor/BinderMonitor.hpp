@@ -19,6 +19,8 @@
 #include <cstdint>
 #include <functional>
 #include <string>
+#include <sys/types.h>
+#include <unordered_map>
 
 /**
  * @brief Callbacks fired by the IProcessObserver binder hosted in ActivityManagerService.
@@ -33,6 +35,7 @@ struct ProcessObserverCallbacks {
 
 using DisplayStateCallback = std::function<void(bool isInteractive)>;
 using PowerSaveCallback = std::function<void(bool isPowerSave)>;
+using GameClassifier = std::function<bool(const std::string &packageName)>;
 
 class BinderMonitor {
 public:
@@ -45,12 +48,23 @@ public:
     ~BinderMonitor();
 
     /**
-     * @brief Resolves all required binder transaction codes at runtime.
+     * @brief Resolves all required binder transaction codes and starts acquiring services.
      *
-     * @return true if all required services and transaction codes were acquired successfully.
+     * Services are acquired concurrently in the background. Every feature attaches as soon as
+     * the services it needs are available and reports its initial state through its callback,
+     * so set the callbacks first.
+     *
+     * @return true if all required transaction codes were resolved.
      */
     bool initialize();
 
+    /**
+     * @brief Blocks until the process observer is attached, which needs activity and package.
+     *
+     * @return true if the process observer is up, false if its services never showed up.
+     */
+    bool waitForCoreServices();
+
     /**
      * @brief Sets the callbacks invoked on IProcessObserver events from ActivityManagerService.
      *
@@ -82,18 +96,68 @@ public:
     /**
      * @brief Queries zen mode from NotificationManagerService.
      *
+     * Answered from cache while an observer on Settings.Global.ZEN_MODE keeps it current,
+     * so only the first call costs a binder round trip.
+     *
      * @return Zen mode integer (0 = off, non-zero = active mode), or -1 on failure.
      */
     int32_t getZenMode();
 
+    /**
+     * @brief Turns Do Not Disturb on (priority only) or off through NotificationManagerService.
+     *
+     * @param enabled True to allow priority interruptions only, false to allow all of them.
+     * @return true if the interruption filter was set, false if unavailable or rejected.
+     */
+    bool setDoNotDisturb(bool enabled);
+
     /**
       * @brief Gets the package name for a given UID from PackageManagerService.
       *
+      * Names are cached per UID, only the first query of a UID costs a binder round trip.
+      *
       * @param uid The UID to query.
       * @return The package name associated with the UID, or an empty string on failure.
       */
     std::string getPackageNameForUid(int32_t uid);
 
+    /**
+     * @brief Sets the function deciding whether a package is a game.
+     *
+     * @param classifier Receives a package name, returns true for games.
+     */
+    void setGameClassifier(GameClassifier classifier);
+
+    /**
+     * @brief Tells whether the package behind a UID is a game, cached per UID.
+     *
+     * @param uid The UID to query.
+     * @param packageName Receives the package name of games, may be nullptr.
+     * @return true if the classifier considers the package a game.
+     */
+    bool isGameUid(int32_t uid, std::string *packageName = nullptr);
+
+    /**
+     * @brief Fills the UID cache from a package list so foreground apps never need a lookup.
+     *
+     * UIDs shared by several packages are left to getPackageNameForUid(), which
+     * reports the shared user instead of one of its packages.
+     *
+     * @param packages Package names mapped to their UID, as read by read_installed_packages().
+     */
+    void primeUidCache(const std::unordered_map<std::string, uid_t> &packages);
+
+    /**
+     * @brief Forgets every cached UID, call when packages are added, removed or replaced.
+     */
+    void invalidatePackageCache();
+
+    /**
+     * @brief Forgets whether UIDs are games while keeping their package names,
+     *        call when the game list changes.
+     */
+    void invalidateGameCache();
+
     /**
      * @brief Blocks the calling thread by joining the binder thread pool.
      */
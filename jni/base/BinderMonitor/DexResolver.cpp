@@ -0,0 +1,497 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DexResolver.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <EncoreLog.hpp>
+
+namespace {
+
+constexpr const char *kFrameworkJar = "/system/framework/framework.jar";
+
+// Zip records, see APPNOTE.TXT
+constexpr uint32_t kZipEocdSignature = 0x06054b50;
+constexpr uint32_t kZipCentralSignature = 0x02014b50;
+constexpr uint32_t kZipLocalSignature = 0x04034b50;
+constexpr size_t kZipEocdSize = 22;
+constexpr size_t kZipCentralSize = 46;
+constexpr size_t kZipLocalSize = 30;
+constexpr uint16_t kZipStored = 0;
+constexpr uint16_t kZipDeflated = 8;
+
+// DEX header offsets, see dex-format
+constexpr size_t kDexHeaderSize = 0x70;
+constexpr size_t kDexStringIds = 0x38;
+constexpr size_t kDexTypeIds = 0x40;
+constexpr size_t kDexFieldIds = 0x50;
+constexpr size_t kDexClassDefs = 0x60;
+constexpr size_t kDexClassDefSize = 32;
+
+// encoded_value types
+constexpr uint8_t kValueInt = 0x04;
+constexpr uint8_t kValueArray = 0x1c;
+constexpr uint8_t kValueAnnotation = 0x1d;
+constexpr uint8_t kValueNull = 0x1e;
+constexpr uint8_t kValueBoolean = 0x1f;
+
+/// Field name to query, per class descriptor
+using QueryIndex = std::unordered_map<std::string, std::unordered_map<std::string, std::string>>;
+
+uint16_t read_u16(const uint8_t *p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t read_u32(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/**
+ * @brief Bounds checked cursor over a DEX image, every read fails once it runs past the end.
+ */
+class DexReader {
+public:
+    DexReader(const uint8_t *data, size_t size, size_t pos)
+        : data_(data)
+        , size_(size)
+        , pos_(pos)
+        , ok_(pos <= size) {
+    }
+
+    bool ok() const {
+        return ok_;
+    }
+
+    uint8_t u8() {
+        if (!ok_ || pos_ >= size_) return fail();
+        return data_[pos_++];
+    }
+
+    uint32_t uleb128() {
+        uint32_t result = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t byte = u8();
+            result |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return result;
+        }
+        return fail();
+    }
+
+    /**
+     * @brief Reads the little endian integer of an encoded_value, sign extended.
+     */
+    int32_t sized_int(size_t size) {
+        uint32_t value = 0;
+        for (size_t i = 0; i < size; i++) {
+            value |= static_cast<uint32_t>(u8()) << (8 * i);
+        }
+        if (size < 4 && (value & (1u << (8 * size - 1)))) {
+            value |= ~0u << (8 * size);
+        }
+        return static_cast<int32_t>(value);
+    }
+
+    void skip(size_t count) {
+        if (!ok_ || count > size_ - pos_) {
+            fail();
+            return;
+        }
+        pos_ += count;
+    }
+
+    /**
+     * @brief Skips an encoded_value without decoding it.
+     */
+    void skip_value(int depth = 0) {
+        skip_payload(u8(), depth);
+    }
+
+    /**
+     * @brief Skips what follows the header byte of an encoded_value.
+     */
+    void skip_payload(uint8_t header, int depth = 0) {
+        if (depth > 8) {
+            fail();
+            return;
+        }
+
+        switch (header & 0x1f) {
+            case kValueNull:
+            case kValueBoolean:
+                return;
+            case kValueArray: {
+                uint32_t count = uleb128();
+                for (uint32_t i = 0; i < count && ok_; i++) skip_value(depth + 1);
+                return;
+            }
+            case kValueAnnotation: {
+                uleb128(); // type_idx
+                uint32_t count = uleb128();
+                for (uint32_t i = 0; i < count && ok_; i++) {
+                    uleb128(); // name_idx
+                    skip_value(depth + 1);
+                }
+                return;
+            }
+            default:
+                skip((header >> 5) + 1u);
+                return;
+        }
+    }
+
+private:
+    const uint8_t *data_;
+    size_t size_;
+    size_t pos_;
+    bool ok_;
+
+    uint8_t fail() {
+        ok_ = false;
+        return 0;
+    }
+};
+
+/**
+ * @brief Turns "android.os.IPowerManager.Stub" into "Landroid/os/IPowerManager$Stub;".
+ *
+ * Packages are lowercase by convention, so the first capitalized segment starts the class
+ * and every segment after it names a nested class.
+ */
+std::string to_descriptor(std::string_view name) {
+    std::string descriptor = "L";
+    bool in_class = false;
+
+    size_t start = 0;
+    while (start <= name.size()) {
+        size_t dot = name.find('.', start);
+        if (dot == std::string_view::npos) dot = name.size();
+
+        std::string_view segment = name.substr(start, dot - start);
+        if (start > 0) descriptor += in_class ? '$' : '/';
+        if (!segment.empty() && segment[0] >= 'A' && segment[0] <= 'Z') in_class = true;
+        descriptor += segment;
+
+        start = dot + 1;
+    }
+
+    descriptor += ';';
+    return descriptor;
+}
+
+/**
+ * @brief Parsed DEX tables needed to walk class definitions.
+ */
+class DexFile {
+public:
+    DexFile(const uint8_t *data, size_t size)
+        : data_(data)
+        , size_(size) {
+    }
+
+    bool valid() const {
+        if (size_ < kDexHeaderSize || memcmp(data_, "dex\n", 4) != 0) return false;
+
+        return table_fits(kDexStringIds, 4) && table_fits(kDexTypeIds, 4) && table_fits(kDexFieldIds, 8) &&
+               table_fits(kDexClassDefs, kDexClassDefSize);
+    }
+
+    /**
+     * @brief Resolves the queries of every class defined in this DEX, removing the ones answered.
+     */
+    void resolve(QueryIndex &pending, std::unordered_map<std::string, uint32_t> &result) const {
+        const uint32_t class_count = read_u32(data_ + kDexClassDefs);
+        const uint8_t *class_defs = data_ + read_u32(data_ + kDexClassDefs + 4);
+
+        for (uint32_t i = 0; i < class_count && !pending.empty(); i++) {
+            const uint8_t *def = class_defs + i * kDexClassDefSize;
+
+            auto it = pending.find(std::string(type_name(read_u32(def))));
+            if (it == pending.end()) continue;
+
+            resolve_class(read_u32(def + 24), read_u32(def + 28), it->second, result);
+            if (it->second.empty()) pending.erase(it);
+        }
+    }
+
+private:
+    const uint8_t *data_;
+    size_t size_;
+
+    bool table_fits(size_t header_offset, size_t item_size) const {
+        uint64_t count = read_u32(data_ + header_offset);
+        uint64_t offset = read_u32(data_ + header_offset + 4);
+        return offset + count * item_size <= size_;
+    }
+
+    std::string_view string(uint32_t index) const {
+        if (index >= read_u32(data_ + kDexStringIds)) return {};
+
+        // Skip the utf16_size prefix, it counts UTF-16 units rather than the bytes of the NUL terminated MUTF-8
+        size_t offset = read_u32(data_ + read_u32(data_ + kDexStringIds + 4) + index * 4);
+        while (offset < size_ && (data_[offset] & 0x80)) offset++;
+        if (++offset >= size_) return {};
+
+        const char *begin = reinterpret_cast<const char *>(data_ + offset);
+        const void *end = memchr(begin, '\0', size_ - offset);
+        if (!end) return {};
+        return {begin, static_cast<size_t>(static_cast<const char *>(end) - begin)};
+    }
+
+    std::string_view type_name(uint32_t index) const {
+        if (index >= read_u32(data_ + kDexTypeIds)) return {};
+        return string(read_u32(data_ + read_u32(data_ + kDexTypeIds + 4) + index * 4));
+    }
+
+    std::string_view field_name(uint32_t index) const {
+        if (index >= read_u32(data_ + kDexFieldIds)) return {};
+        return string(read_u32(data_ + read_u32(data_ + kDexFieldIds + 4) + index * 8 + 4));
+    }
+
+    /**
+     * @brief Matches the static fields of a class against its static_values.
+     *
+     * The n-th entry of static_values initializes the n-th static field of class_data,
+     * trailing fields left out of the array are zero.
+     */
+    void resolve_class(
+        uint32_t class_data_off, uint32_t static_values_off, std::unordered_map<std::string, std::string> &fields,
+        std::unordered_map<std::string, uint32_t> &result
+    ) const {
+        if (class_data_off == 0 || static_values_off == 0) return;
+
+        DexReader class_data(data_, size_, class_data_off);
+        uint32_t static_fields = class_data.uleb128();
+        class_data.uleb128(); // instance_fields_size
+        class_data.uleb128(); // direct_methods_size
+        class_data.uleb128(); // virtual_methods_size
+
+        DexReader values(data_, size_, static_values_off);
+        uint32_t value_count = values.uleb128();
+
+        uint32_t field_idx = 0;
+        for (uint32_t i = 0; i < static_fields && i < value_count && !fields.empty(); i++) {
+            field_idx += class_data.uleb128();
+            class_data.uleb128(); // access_flags
+            if (!class_data.ok() || !values.ok()) return;
+
+            auto it = fields.find(std::string(field_name(field_idx)));
+            if (it == fields.end()) {
+                values.skip_value();
+                continue;
+            }
+
+            uint8_t header = values.u8();
+            if ((header & 0x1f) != kValueInt) {
+                LOGW_TAG("DexResolver", "{} is not an int constant", it->second);
+                values.skip_payload(header);
+                fields.erase(it);
+                continue;
+            }
+
+            int32_t value = values.sized_int((header >> 5) + 1u);
+            if (!values.ok()) return;
+
+            result[it->second] = static_cast<uint32_t>(value);
+            fields.erase(it);
+        }
+    }
+};
+
+/**
+ * @brief Read-only mapping of a jar.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &path) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+
+        struct stat st{};
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void *map = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map != MAP_FAILED) {
+                data_ = static_cast<const uint8_t *>(map);
+                size_ = static_cast<size_t>(st.st_size);
+            }
+        }
+        close(fd);
+    }
+
+    ~MappedFile() {
+        if (data_) munmap(const_cast<uint8_t *>(data_), size_);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const uint8_t *data() const {
+        return data_;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+private:
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Inflates a deflated zip entry.
+ *
+ * @return Entry content, empty on failure.
+ */
+std::vector<uint8_t> inflate_entry(const uint8_t *data, size_t compressed_size, size_t uncompressed_size) {
+    std::vector<uint8_t> out(uncompressed_size);
+
+    z_stream stream{};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) return {};
+
+    stream.next_in = const_cast<Bytef *>(data);
+    stream.avail_in = static_cast<uInt>(compressed_size);
+    stream.next_out = out.data();
+    stream.avail_out = static_cast<uInt>(out.size());
+
+    int ret = inflate(&stream, Z_FINISH);
+    inflateEnd(&stream);
+
+    if (ret != Z_STREAM_END || stream.total_out != uncompressed_size) return {};
+    return out;
+}
+
+/**
+ * @brief Resolves pending queries from every classes*.dex entry of a jar.
+ */
+void resolve_jar(const std::string &path, QueryIndex &pending, std::unordered_map<std::string, uint32_t> &result) {
+    MappedFile jar(path);
+    const uint8_t *data = jar.data();
+    const size_t size = jar.size();
+    if (!data || size < kZipEocdSize) {
+        LOGD_TAG("DexResolver", "Failed to map {}", path);
+        return;
+    }
+
+    // The end of central directory record sits before an optional comment of up to 64 KiB
+    size_t eocd = size - kZipEocdSize;
+    const size_t lowest = size > kZipEocdSize + 0xffff ? size - kZipEocdSize - 0xffff : 0;
+    while (read_u32(data + eocd) != kZipEocdSignature) {
+        if (eocd == lowest) {
+            LOGW_TAG("DexResolver", "{} is not a zip archive", path);
+            return;
+        }
+        eocd--;
+    }
+
+    const uint16_t entry_count = read_u16(data + eocd + 10);
+    size_t offset = read_u32(data + eocd + 16);
+
+    for (uint16_t i = 0; i < entry_count && !pending.empty(); i++) {
+        if (offset + kZipCentralSize > size || read_u32(data + offset) != kZipCentralSignature) break;
+
+        const uint8_t *entry = data + offset;
+        const uint16_t method = read_u16(entry + 10);
+        const uint32_t compressed_size = read_u32(entry + 20);
+        const uint32_t uncompressed_size = read_u32(entry + 24);
+        const uint16_t name_length = read_u16(entry + 28);
+        const size_t local_offset = read_u32(entry + 42);
+        offset += kZipCentralSize + name_length + read_u16(entry + 30) + read_u16(entry + 32);
+        if (offset > size) break;
+
+        std::string_view name(reinterpret_cast<const char *>(entry + kZipCentralSize), name_length);
+        if (!name.starts_with("classes") || !name.ends_with(".dex")) continue;
+
+        if (local_offset + kZipLocalSize > size || read_u32(data + local_offset) != kZipLocalSignature) continue;
+        const size_t data_offset =
+            local_offset + kZipLocalSize + read_u16(data + local_offset + 26) + read_u16(data + local_offset + 28);
+        if (data_offset + compressed_size > size) continue;
+
+        // Boot jars keep their DEX stored and aligned, which parses straight from the mapping
+        std::vector<uint8_t> inflated;
+        const uint8_t *dex = data + data_offset;
+        size_t dex_size = compressed_size;
+        if (method == kZipDeflated) {
+            inflated = inflate_entry(dex, compressed_size, uncompressed_size);
+            dex = inflated.data();
+            dex_size = inflated.size();
+        } else if (method != kZipStored) {
+            continue;
+        }
+
+        DexFile dex_file(dex, dex_size);
+        if (!dex_file.valid()) {
+            LOGW_TAG("DexResolver", "Invalid DEX {} in {}", name, path);
+            continue;
+        }
+        dex_file.resolve(pending, result);
+    }
+}
+
+/**
+ * @brief Jars to search, framework.jar holds nearly every AIDL interface of the framework.
+ */
+std::vector<std::string> framework_jars() {
+    std::vector<std::string> jars = {kFrameworkJar};
+
+    const char *classpath = getenv("BOOTCLASSPATH");
+    if (!classpath) return jars;
+
+    std::string_view remaining = classpath;
+    while (!remaining.empty()) {
+        size_t colon = remaining.find(':');
+        std::string_view jar = remaining.substr(0, colon);
+        if (!jar.empty() && jar != kFrameworkJar) jars.emplace_back(jar);
+        if (colon == std::string_view::npos) break;
+        remaining.remove_prefix(colon + 1);
+    }
+
+    return jars;
+}
+
+} // namespace
+
+std::unordered_map<std::string, uint32_t> DexResolver::resolve(
+    const std::vector<std::string> &queries, const std::vector<std::string> &jars
+) {
+    std::unordered_map<std::string, uint32_t> result;
+
+    QueryIndex pending;
+    for (const auto &query : queries) {
+        size_t sep = query.find("::");
+        if (sep == std::string::npos) {
+            LOGW_TAG("DexResolver", "Malformed query: {}", query);
+            continue;
+        }
+        pending[to_descriptor(std::string_view(query).substr(0, sep))][query.substr(sep + 2)] = query;
+    }
+
+    for (const auto &jar : jars.empty() ? framework_jars() : jars) {
+        if (pending.empty()) break;
+        resolve_jar(jar, pending, result);
+    }
+
+    return result;
+}
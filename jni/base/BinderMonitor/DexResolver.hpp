@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Resolves AIDL transaction codes by reading the framework DEX directly.
+ *
+ * AIDL stubs declare every transaction code as a static final int, whose value javac
+ * folds into the static_values of the Stub class. Reading them out of the jars saves
+ * starting an ART VM through app_process just to look at a few constants.
+ */
+namespace DexResolver {
+
+/**
+ * @brief Looks up "<binary class name>::<field>" queries in the framework jars.
+ *
+ * Searches framework.jar first, then the remaining BOOTCLASSPATH jars, stopping once
+ * every query is answered. Jars whose DEX was stripped in favor of the boot image are skipped.
+ *
+ * @param queries Queries like "android.os.IPowerManager.Stub::TRANSACTION_isInteractive".
+ * @param jars Jars to search instead of the framework ones, mostly for testing.
+ * @return Code of every query found, missing queries are left out.
+ */
+std::unordered_map<std::string, uint32_t> resolve(
+    const std::vector<std::string> &queries, const std::vector<std::string> &jars = {}
+);
+
+} // namespace DexResolver
@@ -7,7 +7,7 @@ LOCAL_MODULE := DeviceInfo
 LOCAL_SRC_FILES := $(wildcard $(LOCAL_PATH)/*.cpp)
 LOCAL_SRC_FILES := $(LOCAL_SRC_FILES:$(LOCAL_PATH)/%=%)
 
-LOCAL_STATIC_LIBRARIES := spdlog
+LOCAL_STATIC_LIBRARIES := rapidjson spdlog
 
 LOCAL_C_INCLUDES := $(ROOT_PATH)/include
 
@@ -37,6 +37,16 @@ const std::string &DeviceInfo::get_device_model() {
     return cached;
 }
 
+const std::string &DeviceInfo::get_build_fingerprint() {
+    static const std::string cached = fetch_build_fingerprint();
+    return cached;
+}
+
+const std::string &DeviceInfo::get_boot_id() {
+    static const std::string cached = fetch_boot_id();
+    return cached;
+}
+
 // --- Private ---
 
 std::string DeviceInfo::fetch_kernel_uname() {
@@ -82,3 +92,26 @@ std::string DeviceInfo::fetch_device_model() {
 
     return result.empty() ? "Unknown" : result;
 }
+
+std::string DeviceInfo::fetch_build_fingerprint() {
+    char prop_value[PROP_VALUE_MAX];
+    int len = __system_property_get("ro.build.fingerprint", prop_value);
+
+    if (len <= 0) {
+        return "Unknown";
+    }
+
+    return std::string(prop_value, len);
+}
+
+std::string DeviceInfo::fetch_boot_id() {
+    std::ifstream file("/proc/sys/kernel/random/boot_id");
+    std::string boot_id;
+
+    if (!file.is_open() || !std::getline(file, boot_id) || boot_id.empty()) {
+        LOGE_TAG("DeviceInfo", "Unable to read boot id");
+        return "Unknown";
+    }
+
+    return boot_id;
+}
@@ -22,9 +22,13 @@ public:
     static const std::string& get_kernel_uname();
     static const std::string& get_soc_model();
     static const std::string& get_device_model();
+    static const std::string& get_build_fingerprint();
+    static const std::string& get_boot_id();
 
 private:
     static std::string fetch_kernel_uname();
     static std::string fetch_soc_model();
     static std::string fetch_device_model();
+    static std::string fetch_build_fingerprint();
+    static std::string fetch_boot_id();
 };
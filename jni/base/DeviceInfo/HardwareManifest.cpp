@@ -0,0 +1,376 @@
+/*
+ * Copyright (C) 2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <filesystem>
+#include <fnmatch.h>
+#include <fstream>
+#include <iterator>
+#include <tuple>
+#include <sys/stat.h>
+
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/filereadstream.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <EncoreLog.hpp>
+
+#include "HardwareManifest.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool stat_mode(const std::string &path, mode_t type) {
+    struct stat st{};
+    return stat(path.c_str(), &st) == 0 && (st.st_mode & S_IFMT) == type;
+}
+
+/**
+ * @brief Loads a {"path": bool} object.
+ */
+bool load_flags(const rapidjson::Value &value, std::unordered_map<std::string, bool> &out) {
+    if (!value.IsObject()) return false;
+    for (auto it = value.MemberBegin(); it != value.MemberEnd(); ++it) {
+        if (!it->value.IsBool()) return false;
+        out.emplace(it->name.GetString(), it->value.GetBool());
+    }
+    return true;
+}
+
+void save_flags(
+    rapidjson::Document &doc, const char *name, const std::unordered_map<std::string, bool> &flags) {
+    auto &allocator = doc.GetAllocator();
+    rapidjson::Value object(rapidjson::kObjectType);
+    for (const auto &[path, present] : flags) {
+        rapidjson::Value key(path.c_str(), allocator);
+        object.AddMember(key, present, allocator);
+    }
+    doc.AddMember(rapidjson::StringRef(name), object, allocator);
+}
+
+} // namespace
+
+HardwareManifest::HardwareManifest(std::string root)
+    : root_(std::move(root)) {
+}
+
+bool HardwareManifest::is_file(const std::string &path) {
+    auto it = files_.find(path);
+    if (it != files_.end()) return it->second;
+    return files_.emplace(path, stat_mode(root_ + path, S_IFREG)).first->second;
+}
+
+bool HardwareManifest::is_dir(const std::string &path) {
+    auto it = dirs_.find(path);
+    if (it != dirs_.end()) return it->second;
+    return dirs_.emplace(path, stat_mode(root_ + path, S_IFDIR)).first->second;
+}
+
+const std::vector<std::string> &HardwareManifest::list(
+    const std::string &dir, const std::string &pattern, bool ignore_case) {
+    const std::string key = list_key(dir, pattern, ignore_case);
+    auto it = lists_.find(key);
+    if (it != lists_.end()) return it->second;
+
+    std::vector<std::string> result;
+    if (DIR *dp = opendir((root_ + dir).c_str())) {
+        const int flags = ignore_case ? FNM_CASEFOLD : 0;
+        while (struct dirent *entry = readdir(dp)) {
+            if (entry->d_name[0] == '.') continue;
+            if (fnmatch(pattern.c_str(), entry->d_name, flags) == 0) {
+                result.push_back(dir + "/" + entry->d_name);
+            }
+        }
+        closedir(dp);
+        std::sort(result.begin(), result.end());
+    }
+
+    return lists_.emplace(key, std::move(result)).first->second;
+}
+
+const std::string &HardwareManifest::find_dir(const std::string &dir, const std::string &pattern) {
+    const std::string key = list_key(dir, pattern, true);
+    auto it = finds_.find(key);
+    if (it != finds_.end()) return it->second;
+
+    std::error_code ec;
+    const std::string base = root_ + dir;
+    std::string match;
+    fs::recursive_directory_iterator walk(base, fs::directory_options::skip_permission_denied, ec);
+
+    for (; !ec && walk != fs::recursive_directory_iterator(); walk.increment(ec)) {
+        const auto &entry = *walk;
+        if (!entry.is_directory(ec) || entry.is_symlink(ec)) continue;
+
+        const std::string name = entry.path().filename().string();
+        if (fnmatch(pattern.c_str(), name.c_str(), FNM_CASEFOLD) == 0) {
+            match = dir + entry.path().string().substr(base.size());
+            break;
+        }
+    }
+
+    return finds_.emplace(key, std::move(match)).first->second;
+}
+
+const std::string &HardwareManifest::read(const std::string &path) {
+    auto it = reads_.find(path);
+    if (it != reads_.end()) return it->second;
+
+    std::string content;
+    std::ifstream file(root_ + path);
+    if (file.is_open()) {
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        content.erase(content.find_last_not_of(" \t\r\n") + 1);
+    }
+
+    return reads_.emplace(path, std::move(content)).first->second;
+}
+
+bool HardwareManifest::load(const std::string &filename, const std::string &key) {
+    FILE *fp = fopen(filename.c_str(), "rb");
+    if (!fp) {
+        LOGD_TAG("HardwareManifest", "{}: {}", filename, strerror(errno));
+        return false;
+    }
+
+    char readBuffer[65536];
+    rapidjson::FileReadStream is(fp, readBuffer, sizeof(readBuffer));
+
+    rapidjson::Document doc;
+    doc.ParseStream(is);
+    fclose(fp);
+
+    if (doc.HasParseError() || !doc.IsObject()) {
+        LOGW_TAG("HardwareManifest", "{}: parse error: {}", filename, rapidjson::GetParseError_En(doc.GetParseError()));
+        return false;
+    }
+
+    if (!doc.HasMember("identity") || !doc["identity"].IsString() || key != doc["identity"].GetString()) {
+        LOGI_TAG("HardwareManifest", "Kernel or build changed, discarding hardware manifest");
+        return false;
+    }
+
+    for (const char *member : {"files", "dirs", "lists", "finds", "reads"}) {
+        if (!doc.HasMember(member)) {
+            LOGW_TAG("HardwareManifest", "{}: missing {}", filename, member);
+            return false;
+        }
+    }
+
+    std::unordered_map<std::string, bool> files, dirs;
+    if (!load_flags(doc["files"], files) || !load_flags(doc["dirs"], dirs)) {
+        LOGW_TAG("HardwareManifest", "{}: invalid node list", filename);
+        return false;
+    }
+
+    // Directory queries are stored as [dir, pattern, ignore_case, result]
+    std::unordered_map<std::string, std::vector<std::string>> lists;
+    std::unordered_map<std::string, std::string> finds;
+    if (!doc["lists"].IsArray() || !doc["finds"].IsArray()) {
+        LOGW_TAG("HardwareManifest", "{}: invalid directory queries", filename);
+        return false;
+    }
+
+    for (const auto &query : doc["lists"].GetArray()) {
+        if (!query.IsArray() || query.Size() != 4 || !query[0u].IsString() || !query[1u].IsString() ||
+            !query[2u].IsBool() || !query[3u].IsArray()) {
+            LOGW_TAG("HardwareManifest", "{}: invalid directory listing", filename);
+            return false;
+        }
+
+        std::vector<std::string> paths;
+        for (const auto &path : query[3u].GetArray()) {
+            if (!path.IsString()) return false;
+            paths.emplace_back(path.GetString());
+        }
+        lists.emplace(list_key(query[0u].GetString(), query[1u].GetString(), query[2u].GetBool()), std::move(paths));
+    }
+
+    for (const auto &query : doc["finds"].GetArray()) {
+        if (!query.IsArray() || query.Size() != 3 || !query[0u].IsString() || !query[1u].IsString() ||
+            !query[2u].IsString()) {
+            LOGW_TAG("HardwareManifest", "{}: invalid directory search", filename);
+            return false;
+        }
+        finds.emplace(list_key(query[0u].GetString(), query[1u].GetString(), true), query[2u].GetString());
+    }
+
+    std::unordered_map<std::string, std::string> reads;
+    if (!doc["reads"].IsObject()) {
+        LOGW_TAG("HardwareManifest", "{}: invalid capability nodes", filename);
+        return false;
+    }
+    for (auto it = doc["reads"].MemberBegin(); it != doc["reads"].MemberEnd(); ++it) {
+        if (!it->value.IsString()) return false;
+        reads.emplace(it->name.GetString(), it->value.GetString());
+    }
+
+    files_ = std::move(files);
+    dirs_ = std::move(dirs);
+    lists_ = std::move(lists);
+    finds_ = std::move(finds);
+    reads_ = std::move(reads);
+    LOGI_TAG("HardwareManifest", "Loaded {} capability probes from {}", size(), filename);
+    return true;
+}
+
+size_t HardwareManifest::recheck_absent() {
+    size_t found = 0;
+
+    for (auto &[path, present] : files_) {
+        if (!present && stat_mode(root_ + path, S_IFREG)) {
+            present = true;
+            found++;
+        }
+    }
+
+    for (auto &[path, present] : dirs_) {
+        if (!present && stat_mode(root_ + path, S_IFDIR)) {
+            present = true;
+            found++;
+        }
+    }
+
+    // Queries are answered again through the regular path, collect them first as that inserts
+    std::vector<std::string> empty_lists, empty_finds, empty_reads;
+    for (const auto &[query, paths] : lists_) {
+        if (paths.empty()) empty_lists.push_back(query);
+    }
+    for (const auto &[query, match] : finds_) {
+        if (match.empty()) empty_finds.push_back(query);
+    }
+    for (const auto &[path, content] : reads_) {
+        if (content.empty()) empty_reads.push_back(path);
+    }
+
+    for (const auto &query : empty_lists) {
+        lists_.erase(query);
+        const auto [dir, pattern, ignore_case] = split_list_key(query);
+        if (!list(dir, pattern, ignore_case).empty()) found++;
+    }
+
+    for (const auto &query : empty_finds) {
+        finds_.erase(query);
+        const auto [dir, pattern, ignore_case] = split_list_key(query);
+        if (!find_dir(dir, pattern).empty()) found++;
+    }
+
+    for (const auto &path : empty_reads) {
+        reads_.erase(path);
+        if (!read(path).empty()) found++;
+    }
+
+    if (found != 0) {
+        LOGI_TAG("HardwareManifest", "{} capabilities appeared since the manifest was recorded", found);
+    }
+    return found;
+}
+
+bool HardwareManifest::save(const std::string &filename, const std::string &key) const {
+    rapidjson::Document doc;
+    doc.SetObject();
+    rapidjson::Document::AllocatorType &allocator = doc.GetAllocator();
+
+    rapidjson::Value identity(key.c_str(), allocator);
+    doc.AddMember("identity", identity, allocator);
+
+    save_flags(doc, "files", files_);
+    save_flags(doc, "dirs", dirs_);
+
+    rapidjson::Value lists(rapidjson::kArrayType);
+    for (const auto &[query, paths] : lists_) {
+        const auto [dir, pattern, ignore_case] = split_list_key(query);
+        rapidjson::Value entry(rapidjson::kArrayType);
+        entry.PushBack(rapidjson::Value(dir.c_str(), allocator), allocator);
+        entry.PushBack(rapidjson::Value(pattern.c_str(), allocator), allocator);
+        entry.PushBack(ignore_case, allocator);
+
+        rapidjson::Value matches(rapidjson::kArrayType);
+        for (const auto &path : paths) {
+            matches.PushBack(rapidjson::Value(path.c_str(), allocator), allocator);
+        }
+        entry.PushBack(matches, allocator);
+        lists.PushBack(entry, allocator);
+    }
+    doc.AddMember("lists", lists, allocator);
+
+    rapidjson::Value finds(rapidjson::kArrayType);
+    for (const auto &[query, match] : finds_) {
+        const auto [dir, pattern, ignore_case] = split_list_key(query);
+        rapidjson::Value entry(rapidjson::kArrayType);
+        entry.PushBack(rapidjson::Value(dir.c_str(), allocator), allocator);
+        entry.PushBack(rapidjson::Value(pattern.c_str(), allocator), allocator);
+        entry.PushBack(rapidjson::Value(match.c_str(), allocator), allocator);
+        finds.PushBack(entry, allocator);
+    }
+    doc.AddMember("finds", finds, allocator);
+
+    rapidjson::Value reads(rapidjson::kObjectType);
+    for (const auto &[path, content] : reads_) {
+        rapidjson::Value name(path.c_str(), allocator);
+        rapidjson::Value value(content.c_str(), allocator);
+        reads.AddMember(name, value, allocator);
+    }
+    doc.AddMember("reads", reads, allocator);
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    doc.Accept(writer);
+
+    std::ofstream output_file(filename);
+    if (!output_file.is_open()) {
+        LOGE_TAG("HardwareManifest", "Failed to write {}", filename);
+        return false;
+    }
+
+    output_file << buffer.GetString();
+    LOGD_TAG("HardwareManifest", "Saved {} capability probes to {}", size(), filename);
+    return true;
+}
+
+size_t HardwareManifest::size() const {
+    return files_.size() + dirs_.size() + lists_.size() + finds_.size() + reads_.size();
+}
+
+void HardwareManifest::clear() {
+    files_.clear();
+    dirs_.clear();
+    lists_.clear();
+    finds_.clear();
+    reads_.clear();
+}
+
+std::string HardwareManifest::list_key(const std::string &dir, const std::string &pattern, bool ignore_case) {
+    std::string key;
+    key.reserve(dir.size() + pattern.size() + 3);
+    key.append(dir).push_back('\0');
+    key.append(pattern).push_back('\0');
+    key.push_back(ignore_case ? '1' : '0');
+    return key;
+}
+
+std::tuple<std::string, std::string, bool> HardwareManifest::split_list_key(const std::string &key) {
+    const size_t first = key.find('\0');
+    const size_t second = key.find('\0', first + 1);
+    return {key.substr(0, first), key.substr(first + 1, second - first - 1), key[second + 1] == '1'};
+}
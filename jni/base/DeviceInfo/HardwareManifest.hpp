@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class HardwareManifest
+ * @brief Records which kernel nodes, GPU backends, bus DCVS devices and vendor modules a device exposes.
+ *
+ * Every capability probe (node existence, directory listings, recursive searches and reads of
+ * static capability nodes such as available governors) is answered from the filesystem once and
+ * remembered. The manifest can be persisted keyed by the running kernel and build, so later
+ * daemon starts and profile transitions never touch the filesystem for discovery.
+ */
+class HardwareManifest {
+public:
+    /**
+     * @param root Prefix prepended to every probed path.
+     */
+    explicit HardwareManifest(std::string root = "");
+
+    /**
+     * @brief Checks whether a regular file exists.
+     */
+    bool is_file(const std::string &path);
+
+    /**
+     * @brief Checks whether a directory exists.
+     */
+    bool is_dir(const std::string &path);
+
+    /**
+     * @brief Lists entries of a directory whose name matches a wildcard pattern.
+     *
+     * @param dir Directory to list.
+     * @param pattern fnmatch(3) pattern matched against entry names.
+     * @param ignore_case Match case-insensitively.
+     * @return Sorted list of matching paths, relative to the root.
+     */
+    const std::vector<std::string> &list(const std::string &dir, const std::string &pattern, bool ignore_case = false);
+
+    /**
+     * @brief Recursively searches a directory for the first directory matching a pattern, case-insensitively.
+     *
+     * @return Path of the first match, or an empty string if nothing matches.
+     */
+    const std::string &find_dir(const std::string &dir, const std::string &pattern);
+
+    /**
+     * @brief Reads a node describing a capability, with trailing whitespace removed.
+     *
+     * Only meant for nodes whose content never changes after boot.
+     *
+     * @return Node content, or an empty string if it cannot be read.
+     */
+    const std::string &read(const std::string &path);
+
+    /**
+     * @brief Loads a manifest persisted by save().
+     *
+     * @param filename Manifest file to load.
+     * @param key Identity of the running kernel and build, the manifest is discarded if it differs.
+     * @return true if the manifest was loaded, false if missing, stale or invalid.
+     */
+    bool load(const std::string &filename, const std::string &key);
+
+    /**
+     * @brief Probes again everything recorded as absent, present nodes are still trusted.
+     *
+     * Nodes of vendor modules loaded late in boot may be missing when the manifest was recorded.
+     *
+     * @return Number of probes that found something this time, the manifest needs saving if non-zero.
+     */
+    size_t recheck_absent();
+
+    /**
+     * @brief Persists every recorded probe.
+     *
+     * @param filename Manifest file to write.
+     * @param key Identity of the running kernel and build.
+     * @return true on success, false otherwise.
+     */
+    bool save(const std::string &filename, const std::string &key) const;
+
+    /**
+     * @brief Number of recorded probes.
+     */
+    size_t size() const;
+
+    void clear();
+
+private:
+    std::string root_;
+    std::unordered_map<std::string, bool> files_;
+    std::unordered_map<std::string, bool> dirs_;
+    std::unordered_map<std::string, std::vector<std::string>> lists_; /// list_key() -> matching paths
+    std::unordered_map<std::string, std::string> finds_;              /// list_key() -> first match
+    std::unordered_map<std::string, std::string> reads_;
+
+    /**
+     * @brief Identifies a directory query, NUL can't appear in paths so it separates the parts.
+     */
+    static std::string list_key(const std::string &dir, const std::string &pattern, bool ignore_case);
+
+    /**
+     * @brief Splits a list_key() back into directory, pattern and case folding.
+     */
+    static std::tuple<std::string, std::string, bool> split_list_key(const std::string &key);
+};
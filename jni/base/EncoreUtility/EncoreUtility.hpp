@@ -20,6 +20,7 @@
 #include <cstdlib>
 #include <string>
 #include <unistd.h>
+#include <unordered_map>
 
 #include <Encore.hpp>
 #include <EncoreLog.hpp>
@@ -40,6 +41,14 @@
  */
 [[nodiscard]] uid_t get_uid_by_package_name(const std::string &package_name);
 
+/**
+ * @brief Reads every installed package and its UID from the PackageManager package list.
+ *
+ * @param path Package list to read, one "<package> <uid> ..." line per package.
+ * @return Package names mapped to their UID in the system user, empty if the list is unreadable.
+ */
+[[nodiscard]] std::unordered_map<std::string, uid_t> read_installed_packages(const std::string &path = PACKAGES_LIST);
+
 /**
  * @brief Posts a notification via shell.
  *
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ProcessScanner.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <EncoreLog.hpp>
+
+ProcessScanner::ProcessScanner(std::chrono::milliseconds max_age)
+    : max_age_(max_age) {}
+
+void ProcessScanner::walk(uid_t uid, VisitFn visit, void *context) {
+    int proc_fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (proc_fd < 0) {
+        LOGE_TAG("ProcessScanner", "Failed to open /proc: {}", strerror(errno));
+        return;
+    }
+
+    alignas(struct dirent64) char entries[8192];
+    char path[32];
+    char cmdline[256];
+
+    for (;;) {
+        long length = syscall(SYS_getdents64, proc_fd, entries, sizeof(entries));
+        if (length <= 0) {
+            if (length < 0) LOGE_TAG("ProcessScanner", "Failed to read /proc: {}", strerror(errno));
+            break;
+        }
+
+        for (long offset = 0; offset < length;) {
+            const auto *entry = reinterpret_cast<const struct dirent64 *>(entries + offset);
+            offset += entry->d_reclen;
+
+            // Processes are the numeric directories
+            if (entry->d_type != DT_DIR || entry->d_name[0] < '1' || entry->d_name[0] > '9') continue;
+
+            const size_t name_length = strlen(entry->d_name);
+            pid_t pid = 0;
+            auto [end, ec] = std::from_chars(entry->d_name, entry->d_name + name_length, pid);
+            if (ec != std::errc() || end != entry->d_name + name_length) continue;
+
+            // /proc/<pid> is owned by the process UID
+            if (uid != kAnyUid) {
+                struct stat st{};
+                if (fstatat(proc_fd, entry->d_name, &st, 0) != 0 || st.st_uid != uid) continue;
+            }
+
+            snprintf(path, sizeof(path), "%s/cmdline", entry->d_name);
+            int cmdline_fd = openat(proc_fd, path, O_RDONLY | O_CLOEXEC);
+            if (cmdline_fd < 0) continue;
+
+            ssize_t read_length = read(cmdline_fd, cmdline, sizeof(cmdline) - 1);
+            close(cmdline_fd);
+
+            // Kernel threads have an empty command line
+            if (read_length <= 0) continue;
+            cmdline[read_length] = '\0';
+
+            if (!visit(context, pid, std::string_view(cmdline, strlen(cmdline)))) {
+                close(proc_fd);
+                return;
+            }
+        }
+    }
+
+    close(proc_fd);
+}
+
+std::vector<ProcessInfo> ProcessScanner::scan(uid_t uid) {
+    const auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cache_valid_ && cache_uid_ == uid && now - cached_at_ < max_age_) {
+        return cache_;
+    }
+
+    cache_.clear();
+    enumerate(uid, [this](pid_t pid, std::string_view name) {
+        cache_.push_back({pid, std::string(name)});
+        return true;
+    });
+
+    cache_uid_ = uid;
+    cached_at_ = now;
+    cache_valid_ = true;
+    return cache_;
+}
+
+std::vector<ProcessInfo> ProcessScanner::find_package(std::string_view package_name, uid_t uid) {
+    std::vector<ProcessInfo> processes;
+    if (package_name.empty()) return processes;
+
+    for (auto &process : scan(uid)) {
+        std::string_view name = process.name;
+        if (!name.starts_with(package_name)) continue;
+
+        if (name.size() == package_name.size()) {
+            processes.insert(processes.begin(), std::move(process));
+        } else if (name[package_name.size()] == ':') {
+            processes.push_back(std::move(process));
+        }
+    }
+    return processes;
+}
+
+void ProcessScanner::invalidate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_valid_ = false;
+    cache_.clear();
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <sys/types.h>
+#include <vector>
+
+struct ProcessInfo {
+    pid_t pid;
+    std::string name; /// First argument of the command line, the process name for apps
+};
+
+/**
+ * @class ProcessScanner
+ * @brief Enumerates processes by reading /proc through getdents64 and fixed stack buffers.
+ *
+ * Processes of other UIDs are skipped on the directory owner before their command line
+ * is opened. Scans are kept for a short while, callers asking again within that window
+ * get the previous result without touching /proc. enumerate() walks without keeping
+ * anything, its visitor is passed down by reference so the walk allocates nothing.
+ */
+class ProcessScanner {
+public:
+    static constexpr uid_t kAnyUid = static_cast<uid_t>(-1);
+
+    /**
+     * @param max_age How long a scan is reused, zero to always rescan.
+     */
+    explicit ProcessScanner(std::chrono::milliseconds max_age = std::chrono::milliseconds(500));
+
+    /**
+     * @brief Lists running processes, kernel threads excluded.
+     *
+     * @param uid Only list processes of this UID, kAnyUid for all of them.
+     * @return The processes, possibly from a scan of the same UID made less than max_age ago.
+     */
+    std::vector<ProcessInfo> scan(uid_t uid = kAnyUid);
+
+    /**
+     * @brief Finds the processes of a package, its main process and every "<package>:<name>" one.
+     *
+     * @param package_name Package to look for.
+     * @param uid UID of the package if known, narrows the scan down to its processes.
+     * @return The processes of the package, the main process first if running.
+     */
+    std::vector<ProcessInfo> find_package(std::string_view package_name, uid_t uid = kAnyUid);
+
+    /**
+     * @brief Drops the kept scan, the next call reads /proc again.
+     */
+    void invalidate();
+
+    /**
+     * @brief Walks /proc, kernel threads excluded.
+     *
+     * @param uid Only visit processes of this UID, kAnyUid for all of them.
+     * @param visit Called as visit(pid, name) for every process, returns false to stop the walk.
+     *              The name is only valid during the call.
+     */
+    template <typename Visitor>
+    static void enumerate(uid_t uid, Visitor &&visit) {
+        walk(uid, [](void *context, pid_t pid, std::string_view name) {
+            return static_cast<bool>((*static_cast<std::remove_reference_t<Visitor> *>(context))(pid, name));
+        }, &visit);
+    }
+
+private:
+    std::mutex mutex_;
+    std::chrono::milliseconds max_age_;
+    std::vector<ProcessInfo> cache_;
+    uid_t cache_uid_ = kAnyUid;
+    std::chrono::steady_clock::time_point cached_at_{};
+    bool cache_valid_ = false;
+
+    using VisitFn = bool (*)(void *context, pid_t pid, std::string_view name);
+
+    /**
+     * @brief The walk behind enumerate(), calls visit(context, pid, name) for every process.
+     */
+    static void walk(uid_t uid, VisitFn visit, void *context);
+};
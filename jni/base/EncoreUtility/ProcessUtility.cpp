@@ -15,60 +15,25 @@
  */
 
 #include <EncoreLog.hpp>
-#include <algorithm>
-#include <filesystem>
-#include <fstream>
-#include <iostream>
+#include <charconv>
+#include <cstdio>
 #include <string>
+#include <sys/stat.h>
 
 #include "EncoreUtility.hpp"
-
-namespace fs = std::filesystem;
+#include "ProcessScanner.hpp"
 
 pid_t pidof(std::string_view target_name, bool strict) {
     if (target_name.empty()) return 0;
 
     pid_t found_pid = 0;
-
-    try {
-        for (const auto &entry : fs::directory_iterator("/proc")) {
-            const std::string dir_name = entry.path().filename().string();
-
-            // Skip non-process directories
-            if (!entry.is_directory() || !std::all_of(dir_name.begin(), dir_name.end(), ::isdigit)) {
-                continue;
-            }
-
-            std::ifstream cmd_file(entry.path() / "cmdline", std::ios::binary);
-            if (!cmd_file.is_open()) continue;
-
-            // Read ONLY the first null-terminated string
-            std::string actual_name;
-            if (!std::getline(cmd_file, actual_name, '\0')) {
-                continue;
-            }
-
-            bool is_match = false;
-            if (strict) {
-                // "com.mobile.legends" matches ONLY "com.mobile.legends"
-                is_match = (actual_name == target_name);
-            } else {
-                // "com.mobile.legends" matches "com.mobile.legends:anything"
-                is_match = (actual_name.find(target_name) != std::string::npos);
-            }
-
-            if (is_match) {
-                found_pid = static_cast<pid_t>(std::stoul(dir_name));
-                break;
-            }
-        }
-    } catch (const fs::filesystem_error &e) {
-        LOGE_TAG("pidof", "Filesystem error: %s", e.what());
-    } catch (const std::exception &e) {
-        LOGE_TAG("pidof", "Error: %s", e.what());
-    } catch (...) {
-        LOGE_TAG("pidof", "Unknown exception occurred");
-    }
+    ProcessScanner::enumerate(ProcessScanner::kAnyUid, [&](pid_t pid, std::string_view name) {
+        // Strict: "com.mobile.legends" matches ONLY "com.mobile.legends",
+        // otherwise it also matches "com.mobile.legends:anything"
+        const bool is_match = strict ? name == target_name : name.find(target_name) != std::string_view::npos;
+        if (is_match) found_pid = pid;
+        return !is_match;
+    });
 
     return found_pid;
 }
@@ -82,3 +47,42 @@ uid_t get_uid_by_package_name(const std::string &package_name) {
 
     return st.st_uid;
 }
+
+std::unordered_map<std::string, uid_t> read_installed_packages(const std::string &path) {
+    std::unordered_map<std::string, uid_t> packages;
+
+    FILE *fp = fopen(path.c_str(), "re");
+    if (!fp) {
+        LOGW_TAG("ProcessUtility", "Failed to open {}", path);
+        return packages;
+    }
+
+    std::string content;
+    char buffer[16384];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+        content.append(buffer, n);
+    }
+    fclose(fp);
+
+    packages.reserve(content.size() / 128);
+    std::string_view rest = content;
+    while (!rest.empty()) {
+        size_t eol = rest.find('\n');
+        std::string_view line = rest.substr(0, eol);
+        rest = eol == std::string_view::npos ? std::string_view{} : rest.substr(eol + 1);
+
+        // <package> <uid> <debuggable> <data dir> <seinfo> <gids> ...
+        size_t name_end = line.find(' ');
+        if (name_end == 0 || name_end == std::string_view::npos) continue;
+
+        uid_t uid = 0;
+        const char *uid_begin = line.data() + name_end + 1;
+        auto [ptr, ec] = std::from_chars(uid_begin, line.data() + line.size(), uid);
+        if (ec != std::errc() || ptr == uid_begin) continue;
+
+        packages.emplace(line.substr(0, name_end), uid);
+    }
+
+    return packages;
+}
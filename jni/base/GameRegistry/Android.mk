@@ -7,7 +7,7 @@ LOCAL_MODULE := GameRegistry
 LOCAL_SRC_FILES := $(wildcard $(LOCAL_PATH)/*.cpp)
 LOCAL_SRC_FILES := $(LOCAL_SRC_FILES:$(LOCAL_PATH)/%=%)
 
-LOCAL_STATIC_LIBRARIES := rapidjson spdlog
+LOCAL_STATIC_LIBRARIES := rapidjson spdlog EncoreUtility
 
 LOCAL_C_INCLUDES := $(ROOT_PATH)/include
 
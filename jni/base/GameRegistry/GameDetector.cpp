@@ -0,0 +1,372 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "GameDetector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <string_view>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include <EncoreLog.hpp>
+
+namespace {
+
+// Engines only games ship, generic libraries from SCHED_LIB_NAMES such as libmain.so are left out
+constexpr std::array<std::string_view, 9> kEngineLibraries = {
+    "libunity.so",
+    "libil2cpp.so",
+    "libUE4.so",
+    "libUnreal.so",
+    "libgodot_android.so",
+    "libgdx.so",
+    "libcocos2dcpp.so",
+    "libcocos2djs.so",
+    "libminecraftpe.so",
+};
+
+constexpr std::string_view kAppDir = "/data/app/";
+
+// Partitions of the build, apps installed there only change with an OTA
+constexpr std::array<std::string_view, 6> kReadOnlyPartitions = {
+    "/system/",
+    "/system_ext/",
+    "/product/",
+    "/vendor/",
+    "/odm/",
+    "/oem/",
+};
+
+// APKs every app maps, none of them is the install directory of the app itself
+constexpr std::array<std::string_view, 2> kSharedApkDirs = {
+    "/system/framework/",
+    "/apex/",
+};
+
+// Bounds of a scan, games map a few thousand regions at most
+constexpr size_t kMaxMapsLines = 16384;
+constexpr size_t kMaxCentralDirectory = 4 << 20;
+
+bool is_engine_library(std::string_view name) {
+    return std::find(kEngineLibraries.begin(), kEngineLibraries.end(), name) != kEngineLibraries.end();
+}
+
+std::string_view basename(std::string_view path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string_view::npos ? path : path.substr(slash + 1);
+}
+
+/**
+ * @brief Returns the path of a /proc/<pid>/maps line, empty for anonymous mappings.
+ */
+std::string_view mapped_path(std::string_view line) {
+    // address perms offset dev inode path
+    size_t pos = 0;
+    for (int field = 0; field < 5; field++) {
+        pos = line.find(' ', pos);
+        if (pos == std::string_view::npos) return {};
+        pos = line.find_first_not_of(' ', pos);
+        if (pos == std::string_view::npos) return {};
+    }
+
+    std::string_view path = line.substr(pos);
+    while (!path.empty() && (path.back() == '\n' || path.back() == ' ')) path.remove_suffix(1);
+    return path.starts_with('/') ? path : std::string_view{};
+}
+
+uint16_t read_u16(const uint8_t *p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t read_u32(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/**
+ * @brief Checks whether an APK embeds an engine library, which is mapped straight out of the
+ *        APK without an extracted file name showing up in the mappings.
+ */
+bool apk_has_engine_library(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size < 22) {
+        close(fd);
+        return false;
+    }
+
+    // The end of central directory record sits before an optional comment of up to 64 KiB
+    const size_t size = static_cast<size_t>(st.st_size);
+    const size_t tail_size = std::min<size_t>(size, 22 + 0xffff);
+    std::vector<uint8_t> tail(tail_size);
+    if (pread(fd, tail.data(), tail_size, static_cast<off_t>(size - tail_size)) != static_cast<ssize_t>(tail_size)) {
+        close(fd);
+        return false;
+    }
+
+    size_t eocd = tail_size - 22;
+    while (read_u32(&tail[eocd]) != 0x06054b50) {
+        if (eocd == 0) {
+            close(fd);
+            return false;
+        }
+        eocd--;
+    }
+
+    const uint32_t cd_size = read_u32(&tail[eocd + 12]);
+    const uint32_t cd_offset = read_u32(&tail[eocd + 16]);
+    if (cd_size > kMaxCentralDirectory || static_cast<size_t>(cd_offset) + cd_size > size) {
+        close(fd);
+        return false;
+    }
+
+    std::vector<uint8_t> cd(cd_size);
+    const bool read_ok = pread(fd, cd.data(), cd_size, cd_offset) == static_cast<ssize_t>(cd_size);
+    close(fd);
+    if (!read_ok) return false;
+
+    for (size_t pos = 0; pos + 46 <= cd.size() && read_u32(&cd[pos]) == 0x02014b50;) {
+        const uint16_t name_length = read_u16(&cd[pos + 28]);
+        if (pos + 46 + name_length > cd.size()) break;
+
+        std::string_view name(reinterpret_cast<const char *>(&cd[pos + 46]), name_length);
+        if (name.starts_with("lib/") && is_engine_library(basename(name))) return true;
+
+        pos += 46 + name_length + read_u16(&cd[pos + 30]) + read_u16(&cd[pos + 32]);
+    }
+    return false;
+}
+
+/**
+ * @brief Checks an install directory for engine libraries, whether the app has loaded them yet or not.
+ *
+ * Covers base.apk with every split APK next to it and the libraries extracted to lib/<abi>/.
+ */
+bool install_dir_has_engine_library(const std::string &code_path) {
+    DIR *dir = opendir(code_path.c_str());
+    if (!dir) return false;
+
+    bool found = false;
+    while (!found) {
+        struct dirent *entry = readdir(dir);
+        if (!entry) break;
+
+        std::string_view name = entry->d_name;
+        if (name.ends_with(".apk")) found = apk_has_engine_library(code_path + '/' + entry->d_name);
+    }
+    closedir(dir);
+    if (found) return true;
+
+    const std::string lib_path = code_path + "/lib";
+    DIR *lib_dir = opendir(lib_path.c_str());
+    if (!lib_dir) return false;
+
+    while (!found) {
+        struct dirent *abi = readdir(lib_dir);
+        if (!abi) break;
+        if (abi->d_name[0] == '.') continue;
+
+        DIR *abi_dir = opendir((lib_path + '/' + abi->d_name).c_str());
+        if (!abi_dir) continue;
+        while (!found) {
+            struct dirent *entry = readdir(abi_dir);
+            if (!entry) break;
+            found = is_engine_library(entry->d_name);
+        }
+        closedir(abi_dir);
+    }
+    closedir(lib_dir);
+    return found;
+}
+
+/**
+ * @brief Tells whether an install directory is on a read-only partition, which only changes with an OTA.
+ */
+bool is_read_only_code_path(std::string_view code_path) {
+    return std::any_of(kReadOnlyPartitions.begin(), kReadOnlyPartitions.end(), [&](std::string_view partition) {
+        return code_path.starts_with(partition);
+    });
+}
+
+bool code_path_valid(const std::string &code_path) {
+    // Verdicts of apps on read-only partitions are dropped by load() once the build changes
+    return code_path.empty() || is_read_only_code_path(code_path) || access(code_path.c_str(), F_OK) == 0;
+}
+
+/**
+ * @brief Tells whether a mapped APK may be the one of the app, rather than a framework, APEX,
+ *        overlay or shared library APK.
+ *
+ * Under /data/app, only the directory named after the package qualifies, others hold updated
+ * shared libraries such as WebView.
+ */
+bool is_app_apk(std::string_view path, const std::string &package_name) {
+    if (!path.ends_with(".apk") || path.find("/overlay/") != std::string_view::npos) return false;
+    for (const auto &dir : kSharedApkDirs) {
+        if (path.starts_with(dir)) return false;
+    }
+    if (!path.starts_with(kAppDir)) return true;
+
+    // /data/app/[~~<random>/]<package>-<random>/base.apk
+    std::string_view dir = path.substr(0, path.rfind('/'));
+    std::string_view name = basename(dir);
+    return name.size() > package_name.size() && name.starts_with(package_name) && name[package_name.size()] == '-';
+}
+
+} // namespace
+
+bool GameDetector::scan_maps(const std::string &package_name, pid_t pid, Verdict &verdict) {
+    const std::string maps_path = "/proc/" + std::to_string(pid) + "/maps";
+    FILE *fp = fopen(maps_path.c_str(), "re");
+    if (!fp) return false;
+
+    verdict = {};
+
+    // An updated system app maps its /data/app copy, which wins over the one on the system image
+    bool installed_in_data = false;
+
+    char line[4096];
+    for (size_t lines = 0; lines < kMaxMapsLines && fgets(line, sizeof(line), fp); lines++) {
+        std::string_view path = mapped_path(line);
+        if (path.empty()) continue;
+
+        if (is_engine_library(basename(path))) {
+            verdict.is_game = true;
+        }
+
+        // base.apk and its splits live in the install directory of the running version
+        if (!installed_in_data && is_app_apk(path, package_name)) {
+            installed_in_data = path.starts_with(kAppDir);
+            if (installed_in_data || verdict.code_path.empty()) {
+                verdict.code_path = std::string(path.substr(0, path.rfind('/')));
+            }
+        }
+    }
+    fclose(fp);
+
+    // Engines are often loaded after the first activity shows up, the install directory has them from the start
+    if (!verdict.is_game && !verdict.code_path.empty()) {
+        verdict.is_game = install_dir_has_engine_library(verdict.code_path);
+    }
+    return true;
+}
+
+bool GameDetector::is_game(const std::string &package_name, pid_t pid) {
+    auto it = verdicts_.find(package_name);
+    if (it != verdicts_.end() && code_path_valid(it->second.code_path)) {
+        return it->second.is_game;
+    }
+
+    Verdict verdict;
+    if (!scan_maps(package_name, pid, verdict)) {
+        LOGD_TAG("GameDetector", "Unable to inspect {} (PID: {})", package_name, pid);
+        return false;
+    }
+
+    if (verdict.is_game) {
+        LOGI_TAG("GameDetector", "Detected {} as a game", package_name);
+    } else if (verdict.code_path.empty()) {
+        // Nothing but the mappings was inspected, the next foreground scans again
+        LOGD_TAG("GameDetector", "{} maps no APK of its own yet, not remembering the verdict", package_name);
+        if (verdicts_.erase(package_name) != 0) dirty_ = true;
+        return false;
+    }
+
+    const bool is_game = verdict.is_game;
+    verdicts_[package_name] = std::move(verdict);
+    dirty_ = true;
+    return is_game;
+}
+
+bool GameDetector::is_known_game(const std::string &package_name) const {
+    auto it = verdicts_.find(package_name);
+    return it != verdicts_.end() && it->second.is_game;
+}
+
+bool GameDetector::load(const std::string &path, const std::string &fingerprint) {
+    std::ifstream file(path);
+    std::string cached_fingerprint;
+    if (!file.is_open() || !std::getline(file, cached_fingerprint)) return false;
+
+    // Apps on read-only partitions may have changed with the build
+    const bool same_build = cached_fingerprint == fingerprint;
+    if (!same_build) {
+        LOGI_TAG("GameDetector", "Build changed, rescanning apps of read-only partitions");
+    }
+
+    // <fingerprint>, then <package> <0|1> [code path]
+    std::unordered_map<std::string, Verdict> verdicts;
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t first = line.find(' ');
+        if (first == std::string::npos || first + 2 > line.size()) {
+            LOGW_TAG("GameDetector", "{}: malformed line, discarding verdicts", path);
+            return false;
+        }
+
+        Verdict verdict;
+        verdict.is_game = line[first + 1] == '1';
+        if (first + 3 < line.size()) verdict.code_path = line.substr(first + 3);
+
+        // Left by older versions, such a verdict is scanned again instead
+        if (!verdict.is_game && verdict.code_path.empty()) continue;
+        if (!same_build && !verdict.code_path.empty() && is_read_only_code_path(verdict.code_path)) continue;
+        verdicts.emplace(line.substr(0, first), std::move(verdict));
+    }
+
+    verdicts_ = std::move(verdicts);
+    dirty_ = !same_build;
+    LOGD_TAG("GameDetector", "Loaded {} verdicts from {}", verdicts_.size(), path);
+    return true;
+}
+
+bool GameDetector::save(const std::string &path, const std::string &fingerprint) {
+    if (!dirty_) return true;
+
+    const std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::trunc);
+        if (!file.is_open()) {
+            LOGW_TAG("GameDetector", "Failed to write {}", tmp_path);
+            return false;
+        }
+
+        file << fingerprint << '\n';
+        for (const auto &[package_name, verdict] : verdicts_) {
+            file << package_name << ' ' << (verdict.is_game ? '1' : '0');
+            if (!verdict.code_path.empty()) file << ' ' << verdict.code_path;
+            file << '\n';
+        }
+    }
+
+    if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+        LOGW_TAG("GameDetector", "Failed to write {}: {}", path, strerror(errno));
+        unlink(tmp_path.c_str());
+        return false;
+    }
+
+    dirty_ = false;
+    return true;
+}
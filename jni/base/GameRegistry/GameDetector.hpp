@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+
+/**
+ * @class GameDetector
+ * @brief Recognizes games that aren't listed by the game engine libraries they load.
+ *
+ * A running app is classified by scanning its memory mappings and the install directory
+ * they point to, every APK and extracted library in it, so engines the app hasn't loaded
+ * yet are found too. The verdict is then remembered together with that directory. Android
+ * installs every version of an app into a new directory, so a verdict stays valid until
+ * the directory disappears, which is checked without reading the mappings again. Apps on
+ * read-only partitions only change with the build, their verdicts are kept until the build
+ * fingerprint changes. An app that maps no APK of its own yet isn't remembered as a
+ * non-game, it is scanned again on its next launch.
+ *
+ * @note Not thread-safe, meant to be used from the profile executor only.
+ */
+class GameDetector {
+public:
+    /**
+     * @brief Tells whether a running app is a game, scanning its mappings if its installed version is unknown.
+     *
+     * @param package_name Package of the app.
+     * @param pid Process of the app, only read if no verdict applies.
+     * @return true if the app loads a game engine.
+     */
+    bool is_game(const std::string &package_name, pid_t pid);
+
+    /**
+     * @brief Tells whether a package was recognized as a game, without scanning anything.
+     */
+    bool is_known_game(const std::string &package_name) const;
+
+    /**
+     * @brief Loads verdicts persisted by save().
+     *
+     * @param fingerprint Build fingerprint, verdicts of apps on read-only partitions are dropped if it changed.
+     * @return true if loaded, false if missing or invalid.
+     */
+    bool load(const std::string &path, const std::string &fingerprint);
+
+    /**
+     * @brief Persists verdicts if any changed since the last load() or save().
+     *
+     * @return true if up to date on disk, false on write failure.
+     */
+    bool save(const std::string &path, const std::string &fingerprint);
+
+private:
+    struct Verdict {
+        std::string code_path; /// Install directory of the version the verdict is about
+        bool is_game = false;
+    };
+
+    std::unordered_map<std::string, Verdict> verdicts_;
+    bool dirty_ = false;
+
+    /**
+     * @brief Scans the mappings of a process and its install directory for game engine libraries.
+     *
+     * @param verdict Receives the install directory, empty if none is mapped, and whether an engine was found.
+     * @return true if the mappings could be read and belong to an installed app.
+     */
+    static bool scan_maps(const std::string &package_name, pid_t pid, Verdict &verdict);
+};
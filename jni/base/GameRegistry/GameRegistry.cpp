@@ -18,10 +18,12 @@
 #include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <thread>
 #include <unistd.h>
 
 #include "GameRegistry.hpp"
 
+#include <EncoreUtility.hpp>
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
 #include <rapidjson/filereadstream.h>
@@ -30,7 +32,7 @@
 
 namespace fs = std::filesystem;
 
-bool GameRegistry::load_from_json(const std::string &filename) {
+bool GameRegistry::load_from_json(const std::string &filename, GameListDiff *diff) {
     if (!fs::exists(filename)) {
         LOGE_TAG("GameRegistry", "{}: File not found", filename);
         return false;
@@ -98,13 +100,22 @@ bool GameRegistry::load_from_json(const std::string &filename) {
         new_list.push_back(std::move(game));
     }
 
-    update_gamelist(new_list);
+    GameListDiff changes = update_gamelist(new_list);
+    if (diff) *diff = std::move(changes);
     LOGI_TAG("GameRegistry", "Loaded gamelist from {}", filename);
     return true;
 }
 
 bool GameRegistry::populate_from_base(const std::string &gamelist, const std::string &baselist) {
-    auto IsAppInstalled = [](const std::string &package_name) -> bool {
+    // One read of the package list instead of a syscall per base entry
+    const auto installed = read_installed_packages();
+    if (installed.empty()) {
+        LOGW_TAG("GameRegistry", "Package list unavailable, checking data directories instead");
+    }
+
+    auto IsAppInstalled = [&installed](const std::string &package_name) -> bool {
+        if (!installed.empty()) return installed.contains(package_name);
+
         std::string path = "/data/data/";
         path += package_name;
         return (access(path.c_str(), F_OK) == 0);
@@ -165,61 +176,167 @@ bool GameRegistry::populate_from_base(const std::string &gamelist, const std::st
     return true;
 }
 
-void GameRegistry::update_gamelist(const std::vector <EncoreGameList> &new_list) {
-    std::lock_guard <std::mutex> lock(mutex_);
+GameRegistry::Snapshot::Snapshot(std::vector <EncoreGameList> games)
+    : games_(std::move(games)) {
+    size_t capacity = 8;
+    while (capacity < games_.size() * 2) capacity <<= 1;
+    slots_.resize(capacity);
+
+    const size_t mask = capacity - 1;
+    size_t kept = 0;
+    for (size_t i = 0; i < games_.size(); i++) {
+        const size_t hash = std::hash<std::string_view>{}(games_[i].package_name);
+
+        size_t pos = hash & mask;
+        bool duplicate = false;
+        while (slots_[pos].index != kEmptySlot) {
+            const Slot &slot = slots_[pos];
+            if (slot.hash == hash && games_[slot.index].package_name == games_[i].package_name) {
+                duplicate = true;
+                break;
+            }
+            pos = (pos + 1) & mask;
+        }
+
+        if (duplicate) {
+            LOGW_TAG("GameRegistry", "Duplicate entry for {}, keeping the first one", games_[i].package_name);
+            continue;
+        }
+
+        // Compact games_ in place, indices only ever move down
+        if (kept != i) games_[kept] = std::move(games_[i]);
+        slots_[pos] = Slot{hash, static_cast<uint32_t>(kept)};
+        kept++;
+    }
+    games_.resize(kept);
+}
+
+const EncoreGameList *GameRegistry::Snapshot::find(std::string_view package_name) const {
+    const size_t hash = std::hash<std::string_view>{}(package_name);
+    const size_t mask = slots_.size() - 1;
+
+    for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+        const Slot &slot = slots_[pos];
+        if (slot.index == kEmptySlot) return nullptr;
+        if (slot.hash == hash && games_[slot.index].package_name == package_name) return &games_[slot.index];
+    }
+}
+
+// Readers announce themselves before loading the snapshot and a reload swaps the snapshot
+// before checking for readers, so either the reload sees the reader or the reader sees the
+// new snapshot. Both sides use sequentially consistent operations for that to hold.
+// A reader counts on the counter of the current epoch, which a reload flips away from
+// before waiting on it.
+GameRegistry::ReadGuard::ReadGuard(const GameRegistry &registry)
+    : readers_(registry.readers_[registry.epoch_.load() & 1]) {
+    readers_.fetch_add(1);
+    snapshot_ = registry.snapshot_.load();
+}
+
+GameRegistry::ReadGuard::~ReadGuard() {
+    readers_.fetch_sub(1);
+}
+
+GameRegistry::GameRegistry()
+    : snapshot_(new Snapshot({})) {
+}
+
+GameRegistry::~GameRegistry() {
+    delete snapshot_.load();
+}
+
+/**
+ * @brief Compares two snapshots entry by entry.
+ */
+static GameListDiff diff_snapshots(const GameRegistry::Snapshot &prev, const GameRegistry::Snapshot &next) {
+    GameListDiff diff;
+
+    for (const auto &game: next.games()) {
+        const EncoreGameList *old = prev.find(game.package_name);
+        if (!old) {
+            diff.added.push_back(game.package_name);
+        } else if (old->lite_mode != game.lite_mode || old->enable_dnd != game.enable_dnd) {
+            diff.changed.push_back(game.package_name);
+        }
+    }
+
+    for (const auto &game: prev.games()) {
+        if (!next.find(game.package_name)) {
+            diff.removed.push_back(game.package_name);
+        }
+    }
 
-    game_packages_.clear();
-    game_packages_.reserve(new_list.size());
+    return diff;
+}
+
+GameListDiff GameRegistry::update_gamelist(const std::vector <EncoreGameList> &new_list) {
+    std::vector <EncoreGameList> games;
+    games.reserve(new_list.size());
 
     for (const auto &game: new_list) {
         if (validate_game_entry(game)) {
-            game_packages_.push_back(game);
+            games.push_back(game);
         }
     }
 
-    std::sort(game_packages_.begin(), game_packages_.end(),
-              [](const EncoreGameList &a, const EncoreGameList &b) {
-                  return a.package_name < b.package_name;
-              });
+    // Built outside of any lock, readers keep using the current snapshot meanwhile
+    auto *next = new Snapshot(std::move(games));
+    const size_t count = next->games().size();
 
-    LOGI_TAG("GameRegistry", "Updated registry with {} games", game_packages_.size());
-}
+    std::lock_guard <std::mutex> lock(update_mutex_);
 
-const EncoreGameList *GameRegistry::find_game_ptr(const std::string &package_name) const {
-    std::lock_guard <std::mutex> lock(mutex_);
+    // Only reloads serialized by update_mutex_ replace the snapshot, so it stays valid here
+    GameListDiff diff = diff_snapshots(*snapshot_.load(), *next);
+    if (diff.empty()) {
+        delete next;
+        LOGD_TAG("GameRegistry", "Gamelist unchanged, keeping registry");
+        return diff;
+    }
 
-    auto it = std::lower_bound(game_packages_.begin(), game_packages_.end(), package_name,
-                               [](const EncoreGameList &game, const std::string &name) {
-                                   return game.package_name < name;
-                               });
+    const Snapshot *prev = snapshot_.exchange(next);
 
-    if (it != game_packages_.end() && it->package_name == package_name) {
-        return &(*it);
+    // New readers move to the other counter on each flip, only those that may hold prev are
+    // waited for. A reader may have picked its counter just before a flip, flipping twice
+    // drains both counters once.
+    for (int phase = 0; phase < 2; phase++) {
+        std::atomic <uint32_t> &readers = readers_[epoch_.fetch_add(1) & 1];
+        while (readers.load() != 0) {
+            std::this_thread::yield();
+        }
     }
+    delete prev;
+
+    LOGI_TAG("GameRegistry", "Updated registry with {} games ({} added, {} removed, {} changed)",
+             count, diff.added.size(), diff.removed.size(), diff.changed.size());
+    return diff;
+}
 
-    return nullptr;
+GameRegistry::ReadGuard GameRegistry::read() const {
+    return ReadGuard(*this);
 }
 
 std::optional <EncoreGameList> GameRegistry::find_game(const std::string &package_name) const {
-    const EncoreGameList *game = find_game_ptr(package_name);
+    ReadGuard snapshot(*this);
+    const EncoreGameList *game = snapshot->find(package_name);
     return game ? std::make_optional(*game) : std::nullopt;
 }
 
 bool GameRegistry::is_game_registered(const std::string &package_name) const {
-    return find_game_ptr(package_name) != nullptr;
+    ReadGuard snapshot(*this);
+    return snapshot->find(package_name) != nullptr;
 }
 
 size_t GameRegistry::size() const {
-    std::lock_guard <std::mutex> lock(mutex_);
-    return game_packages_.size();
+    ReadGuard snapshot(*this);
+    return snapshot->games().size();
 }
 
 std::vector <std::string> GameRegistry::get_all_package_names() const {
-    std::lock_guard <std::mutex> lock(mutex_);
+    ReadGuard snapshot(*this);
     std::vector <std::string> packages;
-    packages.reserve(game_packages_.size());
+    packages.reserve(snapshot->games().size());
 
-    for (const auto &game: game_packages_) {
+    for (const auto &game: snapshot->games()) {
         packages.push_back(game.package_name);
     }
 
@@ -16,26 +16,111 @@
 
 #pragma once
 
-#include <optional>
+#include <atomic>
+#include <cstdint>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "Encore.hpp"
 #include "EncoreLog.hpp"
 
-class GameRegistry {
-private:
-    std::vector <EncoreGameList> game_packages_;
-    mutable std::mutex mutex_;
+/**
+ * @brief Packages whose registry entry a reload added, removed or changed.
+ */
+struct GameListDiff {
+    std::vector <std::string> added;
+    std::vector <std::string> removed;
+    std::vector <std::string> changed; /// lite_mode or enable_dnd differ
 
+    bool empty() const {
+        return added.empty() && removed.empty() && changed.empty();
+    }
+};
+
+class GameRegistry {
 public:
+    /**
+     * @brief Immutable game table, a reload builds a new one and publishes it whole.
+     *
+     * Games are looked up through an open addressing table of precomputed hashes, so a miss
+     * (nearly every foreground app) usually costs one hash and no string comparison.
+     */
+    class Snapshot {
+    public:
+        /**
+         * @param games Games to index, later duplicates of a package are dropped.
+         */
+        explicit Snapshot(std::vector <EncoreGameList> games);
+
+        /**
+         * @brief Finds a game by package name
+         * @param package_name The package name to search for
+         * @return Pointer to the game, valid as long as the snapshot, nullptr if not found
+         */
+        const EncoreGameList *find(std::string_view package_name) const;
+
+        /**
+         * @brief Gets all games of the snapshot, in gamelist order
+         */
+        const std::vector <EncoreGameList> &games() const {
+            return games_;
+        }
+
+    private:
+        static constexpr uint32_t kEmptySlot = UINT32_MAX;
+
+        struct Slot {
+            size_t hash = 0;
+            uint32_t index = kEmptySlot; /// Index into games_
+        };
+
+        std::vector <EncoreGameList> games_;
+        std::vector <Slot> slots_; /// Power of two sized, at most half full
+    };
+
+    /**
+     * @brief Pins the snapshot current at construction, keep it short lived.
+     *
+     * Taking and releasing a guard never blocks, a reload waits for guards on the snapshot
+     * it replaces to be released before freeing it.
+     */
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const GameRegistry &registry);
+        ~ReadGuard();
+
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+
+        const Snapshot *operator->() const {
+            return snapshot_;
+        }
+
+        const Snapshot &operator*() const {
+            return *snapshot_;
+        }
+
+    private:
+        std::atomic <uint32_t> &readers_; /// Counter of the epoch current at construction
+        const Snapshot *snapshot_;
+    };
+
+    GameRegistry();
+    ~GameRegistry();
+
+    GameRegistry(const GameRegistry &) = delete;
+    GameRegistry &operator=(const GameRegistry &) = delete;
+
     /**
      * @brief Loads game list from JSON file
      * @param filename Path to the JSON file
+     * @param diff Receives what changed compared to the previous list, may be nullptr
      * @return True if successful, false otherwise
      */
-    bool load_from_json(const std::string &filename);
+    bool load_from_json(const std::string &filename, GameListDiff *diff = nullptr);
 
     /**
      * @brief Populates game list from base file and saves as JSON
@@ -46,27 +131,27 @@ public:
     static bool populate_from_base(const std::string &gamelist, const std::string &baselist);
 
     /**
-     * @brief Updates the game registry with new game list data
+     * @brief Replaces the game registry with new game list data
      * @param new_list The new list of games to register
+     * @return What changed, the registry is left untouched if nothing did
+     * @note Waits for readers of the previous snapshot, never call while holding a ReadGuard
      */
-    void update_gamelist(const std::vector <EncoreGameList> &new_list);
+    GameListDiff update_gamelist(const std::vector <EncoreGameList> &new_list);
 
     /**
-     * @brief Finds a game by package name
-     * @param package_name The package name to search for
-     * @return Optional containing the game if found, empty if not found
+     * @brief Pins the current snapshot for several consistent lookups
      */
-    std::optional <EncoreGameList> find_game(const std::string &package_name) const;
+    ReadGuard read() const;
 
     /**
-     * @brief Finds a game by package name (pointer version for performance)
+     * @brief Finds a game by package name
      * @param package_name The package name to search for
-     * @return Pointer to the game if found, nullptr if not found
+     * @return Optional containing the game if found, empty if not found
      */
-    const EncoreGameList *find_game_ptr(const std::string &package_name) const;
+    std::optional <EncoreGameList> find_game(const std::string &package_name) const;
 
     /**
-     * @brief Checks if a package is registered as a game
+     * @brief Checks if a package is registered as a game, wait-free
      * @param package_name The package name to check
      * @return True if the package is a registered game
      */
@@ -85,6 +170,11 @@ public:
     std::vector <std::string> get_all_package_names() const;
 
 private:
+    std::atomic<const Snapshot *> snapshot_; /// Never null
+    std::atomic <uint32_t> epoch_{0}; /// Its parity picks the counter new ReadGuards use
+    mutable std::atomic <uint32_t> readers_[2]{}; /// Live ReadGuards per epoch parity
+    std::mutex update_mutex_; /// Serializes reloads
+
     /**
      * @brief Validates a game entry before adding to registry
      * @param game The game entry to validate
@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/filereadstream.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <EncoreLog.hpp>
+
+#include "FreqTable.hpp"
+
+namespace {
+
+std::string read_node(const std::string &path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return "";
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+FreqTable parse_freq_table(const std::string &content) {
+    FreqTable table;
+    const char *it = content.data();
+    const char *end = it + content.size();
+
+    while (it < end) {
+        while (it < end && (*it < '0' || *it > '9')) ++it;
+        uint64_t value = 0;
+        auto [next, ec] = std::from_chars(it, end, value);
+        if (ec == std::errc() && next != it) table.freqs.push_back(value);
+        it = next == it ? it + 1 : next;
+    }
+
+    std::sort(table.freqs.begin(), table.freqs.end());
+    return table;
+}
+
+OppTable parse_opp_table(const std::string &content) {
+    OppTable table;
+    std::istringstream lines(content);
+    std::string line;
+
+    while (std::getline(lines, line)) {
+        OppTable::Row row{"", 0};
+
+        auto open = line.find('[');
+        auto close = line.find(']', open);
+        if (open != std::string::npos && close != std::string::npos) {
+            row.index = line.substr(open + 1, close - open - 1);
+        }
+
+        auto pos = line.find("freq = ");
+        if (pos != std::string::npos) {
+            const char *begin = line.data() + pos + 7;
+            std::from_chars(begin, line.data() + line.size(), row.freq);
+        }
+
+        if (!row.index.empty() || row.freq != 0) {
+            table.rows.push_back(std::move(row));
+        }
+    }
+
+    return table;
+}
+
+} // namespace
+
+// =============================================================================
+// FreqTable / OppTable
+// =============================================================================
+
+bool FreqTable::empty() const {
+    return freqs.empty();
+}
+
+uint64_t FreqTable::max() const {
+    return freqs.empty() ? 0 : freqs.back();
+}
+
+uint64_t FreqTable::min() const {
+    return freqs.empty() ? 0 : freqs.front();
+}
+
+uint64_t FreqTable::mid() const {
+    if (freqs.empty()) return 0;
+    return freqs[freqs.size() - (freqs.size() + 1) / 2];
+}
+
+std::string OppTable::last_index() const {
+    for (auto it = rows.rbegin(); it != rows.rend(); ++it) {
+        if (!it->index.empty()) return it->index;
+    }
+    return "";
+}
+
+uint64_t OppTable::edge_freq(bool first) const {
+    if (first) {
+        for (const auto &row : rows) {
+            if (row.freq != 0) return row.freq;
+        }
+    } else {
+        for (auto it = rows.rbegin(); it != rows.rend(); ++it) {
+            if (it->freq != 0) return it->freq;
+        }
+    }
+    return 0;
+}
+
+// =============================================================================
+// FreqTableCache
+// =============================================================================
+
+FreqTableCache::FreqTableCache(std::string root)
+    : root_(std::move(root)) {
+}
+
+const FreqTable &FreqTableCache::table(const std::string &path) {
+    auto it = tables_.find(path);
+    if (it != tables_.end() && !it->second.empty()) return it->second;
+
+    // Missing tables are probed again, the driver behind them may load late
+    FreqTable &table = tables_[path];
+    table = parse_freq_table(read_node(root_ + path));
+    return table;
+}
+
+const OppTable &FreqTableCache::opp_table(const std::string &path) {
+    auto it = opp_tables_.find(path);
+    if (it != opp_tables_.end() && !it->second.rows.empty()) return it->second;
+
+    OppTable &table = opp_tables_[path];
+    table = parse_opp_table(read_node(root_ + path));
+    return table;
+}
+
+bool FreqTableCache::load(const std::string &filename, const std::string &key) {
+    FILE *fp = fopen(filename.c_str(), "rb");
+    if (!fp) {
+        LOGD_TAG("FreqTableCache", "{}: {}", filename, strerror(errno));
+        return false;
+    }
+
+    char readBuffer[65536];
+    rapidjson::FileReadStream is(fp, readBuffer, sizeof(readBuffer));
+
+    rapidjson::Document doc;
+    doc.ParseStream(is);
+    fclose(fp);
+
+    if (doc.HasParseError() || !doc.IsObject()) {
+        LOGW_TAG("FreqTableCache", "{}: parse error: {}", filename, rapidjson::GetParseError_En(doc.GetParseError()));
+        return false;
+    }
+
+    if (!doc.HasMember("kernel") || !doc["kernel"].IsString() || key != doc["kernel"].GetString()) {
+        LOGI_TAG("FreqTableCache", "Kernel or build changed, discarding frequency table cache");
+        return false;
+    }
+
+    if (!doc.HasMember("tables") || !doc["tables"].IsObject() || !doc.HasMember("opp_tables") ||
+        !doc["opp_tables"].IsObject()) {
+        LOGW_TAG("FreqTableCache", "{}: invalid cache layout", filename);
+        return false;
+    }
+
+    std::unordered_map<std::string, FreqTable> tables;
+    for (auto it = doc["tables"].MemberBegin(); it != doc["tables"].MemberEnd(); ++it) {
+        if (!it->value.IsArray()) return false;
+
+        FreqTable table;
+        for (const auto &freq : it->value.GetArray()) {
+            if (!freq.IsUint64()) return false;
+            table.freqs.push_back(freq.GetUint64());
+        }
+        if (table.empty()) continue;
+        tables.emplace(it->name.GetString(), std::move(table));
+    }
+
+    std::unordered_map<std::string, OppTable> opp_tables;
+    for (auto it = doc["opp_tables"].MemberBegin(); it != doc["opp_tables"].MemberEnd(); ++it) {
+        if (!it->value.IsArray()) return false;
+
+        OppTable table;
+        for (const auto &row : it->value.GetArray()) {
+            if (!row.IsArray() || row.Size() != 2 || !row[0u].IsString() || !row[1u].IsUint64()) return false;
+            table.rows.push_back(OppTable::Row{row[0u].GetString(), row[1u].GetUint64()});
+        }
+        if (table.rows.empty()) continue;
+        opp_tables.emplace(it->name.GetString(), std::move(table));
+    }
+
+    tables_ = std::move(tables);
+    opp_tables_ = std::move(opp_tables);
+    LOGI_TAG("FreqTableCache", "Loaded {} frequency tables from {}", size(), filename);
+    return true;
+}
+
+bool FreqTableCache::save(const std::string &filename, const std::string &key) const {
+    rapidjson::Document doc;
+    doc.SetObject();
+    rapidjson::Document::AllocatorType &allocator = doc.GetAllocator();
+
+    rapidjson::Value kernel(key.c_str(), allocator);
+    doc.AddMember("kernel", kernel, allocator);
+
+    rapidjson::Value tables(rapidjson::kObjectType);
+    // Missing tables are left out so they get probed again next time
+    for (const auto &[path, table] : tables_) {
+        if (table.empty()) continue;
+
+        rapidjson::Value freqs(rapidjson::kArrayType);
+        for (uint64_t freq : table.freqs) {
+            freqs.PushBack(freq, allocator);
+        }
+        rapidjson::Value name(path.c_str(), allocator);
+        tables.AddMember(name, freqs, allocator);
+    }
+    doc.AddMember("tables", tables, allocator);
+
+    rapidjson::Value opp_tables(rapidjson::kObjectType);
+    for (const auto &[path, table] : opp_tables_) {
+        if (table.rows.empty()) continue;
+
+        rapidjson::Value rows(rapidjson::kArrayType);
+        for (const auto &row : table.rows) {
+            rapidjson::Value entry(rapidjson::kArrayType);
+            rapidjson::Value index(row.index.c_str(), allocator);
+            entry.PushBack(index, allocator);
+            entry.PushBack(row.freq, allocator);
+            rows.PushBack(entry, allocator);
+        }
+        rapidjson::Value name(path.c_str(), allocator);
+        opp_tables.AddMember(name, rows, allocator);
+    }
+    doc.AddMember("opp_tables", opp_tables, allocator);
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    doc.Accept(writer);
+
+    std::ofstream output_file(filename);
+    if (!output_file.is_open()) {
+        LOGE_TAG("FreqTableCache", "Failed to write {}", filename);
+        return false;
+    }
+
+    output_file << buffer.GetString();
+    LOGD_TAG("FreqTableCache", "Saved {} frequency tables to {}", size(), filename);
+    return true;
+}
+
+size_t FreqTableCache::size() const {
+    return tables_.size() + opp_tables_.size();
+}
+
+void FreqTableCache::clear() {
+    tables_.clear();
+    opp_tables_.clear();
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Frequencies listed by a cpufreq, devfreq or GPU frequency table node.
+ */
+struct FreqTable {
+    std::vector<uint64_t> freqs; /// Ascending, as listed by the kernel after sorting
+
+    bool empty() const;
+    uint64_t max() const;
+    uint64_t min() const;
+
+    /**
+     * @brief Middle frequency, rounded towards the higher half.
+     */
+    uint64_t mid() const;
+};
+
+/**
+ * @brief Rows of a MediaTek GPU OPP table such as gpufreq_opp_dump.
+ */
+struct OppTable {
+    struct Row {
+        std::string index;     /// Bracketed OPP index, empty if the row has none
+        uint64_t freq;         /// "freq = N" value, 0 if the row has none
+    };
+
+    std::vector<Row> rows;
+
+    /**
+     * @brief Index of the last row, i.e. the lowest OPP.
+     */
+    std::string last_index() const;
+
+    /**
+     * @brief Frequency of the first or last row carrying one.
+     */
+    uint64_t edge_freq(bool first) const;
+};
+
+/**
+ * @class FreqTableCache
+ * @brief Memoizes parsed frequency tables, which never change after boot.
+ *
+ * Tables are parsed on first use and may be persisted, keyed by the running kernel and build,
+ * so profile transitions never parse a table on the hot path.
+ */
+class FreqTableCache {
+public:
+    /**
+     * @param root Prefix prepended to every node path when reading tables.
+     */
+    explicit FreqTableCache(std::string root);
+
+    /**
+     * @brief Gets a frequency table, parsing the node on first use or while it is empty.
+     *
+     * @param path Table node path relative to the root.
+     * @return Parsed table, empty if the node is missing or unreadable.
+     */
+    const FreqTable &table(const std::string &path);
+
+    /**
+     * @brief Gets a MediaTek GPU OPP table, parsing the node on first use or while it has no rows.
+     *
+     * @param path Table node path relative to the root.
+     * @return Parsed table, without rows if the node is missing or unreadable.
+     */
+    const OppTable &opp_table(const std::string &path);
+
+    /**
+     * @brief Loads tables persisted by save().
+     *
+     * @param filename Cache file to load.
+     * @param key Identity of the running kernel and build, the cache is discarded if it differs.
+     * @return true if the cache was loaded, false if missing, stale or invalid.
+     */
+    bool load(const std::string &filename, const std::string &key);
+
+    /**
+     * @brief Persists every parsed table that isn't empty.
+     *
+     * @param filename Cache file to write.
+     * @param key Identity of the running kernel and build.
+     * @return true on success, false otherwise.
+     */
+    bool save(const std::string &filename, const std::string &key) const;
+
+    /**
+     * @brief Number of cached tables.
+     */
+    size_t size() const;
+
+    void clear();
+
+private:
+    std::string root_;
+    std::unordered_map<std::string, FreqTable> tables_;
+    std::unordered_map<std::string, OppTable> opp_tables_;
+};
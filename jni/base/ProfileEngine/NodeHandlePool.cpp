@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/magic.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+#include <EncoreLog.hpp>
+
+#include "NodeHandlePool.hpp"
+
+namespace {
+
+/**
+ * @brief Checks whether a descriptor lives on a kernel pseudo filesystem.
+ *
+ * Writes there replace the value, while a regular file has to be truncated after pwrite().
+ */
+bool is_pseudo_fs(int fd) {
+    struct statfs st{};
+    if (fstatfs(fd, &st) != 0) return true;
+
+    switch (static_cast<unsigned long>(st.f_type)) {
+        case SYSFS_MAGIC:
+        case PROC_SUPER_MAGIC:
+        case CGROUP_SUPER_MAGIC:
+        case CGROUP2_SUPER_MAGIC:
+        case DEBUGFS_MAGIC:
+        case TRACEFS_MAGIC:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Errors after which a descriptor is considered stale and worth reopening.
+ */
+bool is_stale_error(int err) {
+    return err == ENODEV || err == ENOENT || err == EBADF || err == ESTALE || err == ENXIO;
+}
+
+} // namespace
+
+NodeHandlePool::NodeHandlePool(size_t capacity)
+    : capacity_(capacity) {
+}
+
+NodeHandlePool::~NodeHandlePool() {
+    close_all();
+}
+
+bool NodeHandlePool::write(const std::string &path, std::string_view data, WriteMode mode) {
+    Handle *cached = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = handles_.find(path);
+        if (it != handles_.end()) cached = &it->second;
+    }
+
+    if (!cached) {
+        Handle handle = open_node(path, mode);
+        if (handle.fd < 0) return false;
+
+        const bool ok = write_fd(handle, data);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (handles_.size() < capacity_) {
+            handles_.emplace(path, handle);
+        } else {
+            close(handle.fd);
+        }
+        return ok;
+    }
+
+    Handle &handle = *cached;
+
+    // Only touch permissions when the node switches between locked and unlocked
+    if (mode == WriteMode::Apply && !handle.locked) {
+        chmod(path.c_str(), 0444);
+        handle.locked = true;
+    } else if (mode == WriteMode::Write && handle.locked) {
+        chmod(path.c_str(), 0644);
+        handle.locked = false;
+    }
+
+    if (write_fd(handle, data)) return true;
+    if (!is_stale_error(errno)) return false;
+
+    LOGT_TAG("NodeHandlePool", "Reopening stale node {}", path);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        close(handle.fd);
+        handles_.erase(path);
+    }
+
+    Handle reopened = open_node(path, mode);
+    if (reopened.fd < 0) return false;
+
+    const bool ok = write_fd(reopened, data);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    handles_.emplace(path, reopened);
+    return ok;
+}
+
+void NodeHandlePool::close_all() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &[path, handle] : handles_) {
+        close(handle.fd);
+    }
+    handles_.clear();
+}
+
+size_t NodeHandlePool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return handles_.size();
+}
+
+NodeHandlePool::Handle NodeHandlePool::open_node(const std::string &path, WriteMode mode) {
+    if (mode != WriteMode::Raw) chmod(path.c_str(), 0644);
+
+    Handle handle{open(path.c_str(), O_WRONLY | O_CLOEXEC), false, false};
+    if (handle.fd < 0) {
+        LOGT_TAG("NodeHandlePool", "open {} failed: {}", path, strerror(errno));
+        return handle;
+    }
+
+    // The descriptor keeps write access once the node is read-only
+    if (mode == WriteMode::Apply) {
+        chmod(path.c_str(), 0444);
+        handle.locked = true;
+    }
+
+    handle.truncate = !is_pseudo_fs(handle.fd);
+    return handle;
+}
+
+bool NodeHandlePool::write_fd(const Handle &handle, std::string_view data) {
+    ssize_t written = pwrite(handle.fd, data.data(), data.size(), 0);
+
+    // Some procfs nodes are not seekable
+    if (written < 0 && errno == ESPIPE) {
+        written = ::write(handle.fd, data.data(), data.size());
+    }
+
+    if (written != static_cast<ssize_t>(data.size())) return false;
+    if (handle.truncate) ftruncate(handle.fd, static_cast<off_t>(data.size()));
+    return true;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "ProfileEngine.hpp"
+
+/**
+ * @class NodeHandlePool
+ * @brief Keeps control nodes open across profile transitions.
+ *
+ * Each node is opened once and written with pwrite() at offset 0. An open descriptor stays
+ * writable after the node is made read-only, so the chmod lock only changes when a node
+ * switches between locked and unlocked writes instead of around every write.
+ *
+ * Different nodes may be written concurrently, a single node must only be written by one thread at a time.
+ */
+class NodeHandlePool {
+public:
+    /**
+     * @param capacity Maximum number of descriptors kept open, writes beyond it use a one-shot open.
+     */
+    explicit NodeHandlePool(size_t capacity = 256);
+    ~NodeHandlePool();
+
+    NodeHandlePool(const NodeHandlePool &) = delete;
+    NodeHandlePool &operator=(const NodeHandlePool &) = delete;
+
+    /**
+     * @brief Writes data to a node, opening it on first use.
+     *
+     * A stale descriptor (e.g. the node disappeared on CPU hotplug) is reopened once.
+     *
+     * @param path Absolute path of the node.
+     * @param data Data to write.
+     * @param mode Permission handling around the write.
+     * @return true if the data was written, false otherwise.
+     */
+    bool write(const std::string &path, std::string_view data, WriteMode mode);
+
+    /**
+     * @brief Closes every open descriptor and forgets the lock state of all nodes.
+     */
+    void close_all();
+
+    /**
+     * @brief Number of open descriptors.
+     */
+    size_t size() const;
+
+private:
+    struct Handle {
+        int fd;
+        bool truncate; /// Backed by a regular filesystem (e.g. a fake tree), not a pseudo filesystem
+        bool locked;   /// Node was last made read-only by us
+    };
+
+    std::unordered_map<std::string, Handle> handles_; /// Elements stay in place on rehash
+    size_t capacity_;
+    mutable std::mutex mutex_;                         /// Guards the map, not the descriptors
+
+    /**
+     * @brief Opens a node for writing, applying the permission handling of the mode.
+     *
+     * @return Handle with fd set to -1 if the node cannot be opened.
+     */
+    static Handle open_node(const std::string &path, WriteMode mode);
+
+    /**
+     * @brief Writes data at offset 0 of an open node.
+     */
+    static bool write_fd(const Handle &handle, std::string_view data);
+};
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <HardwareManifest.hpp>
+
+#include "FreqTable.hpp"
+#include "ProfileEngine.hpp"
+
+/**
+ * @class PlanBuilder
+ * @brief Collects the node writes of a profile and answers filesystem queries while doing so.
+ *
+ * All paths passed in and stored in the plan are relative to the engine root.
+ * Filesystem queries are answered by the hardware manifest, so once it has been
+ * populated building a plan doesn't probe the filesystem.
+ */
+class PlanBuilder {
+public:
+    PlanBuilder(const ProfileOptions &options, FreqTableCache &freq_tables, HardwareManifest &manifest);
+
+    /**
+     * @brief Queues a locked write, skipped if the node does not exist.
+     */
+    void apply(std::string_view value, const std::string &path);
+
+    /**
+     * @brief Queues an unlocked write, skipped if the node does not exist.
+     */
+    void write(std::string_view value, const std::string &path);
+
+    /**
+     * @brief Queues a write without permission changes, skipped if the node does not exist.
+     */
+    void raw(std::string_view value, const std::string &path);
+
+    /**
+     * @brief Queues a write with an explicit mode, skipped if the node does not exist.
+     */
+    void push(std::string_view value, const std::string &path, WriteMode mode);
+
+    /**
+     * @brief Makes every following write wait until all writes queued so far completed.
+     *
+     * Only needed across node directories, writes within a directory always keep their order.
+     */
+    void barrier();
+
+    /**
+     * @brief Checks whether a regular file exists.
+     */
+    bool exists(const std::string &path) const;
+
+    /**
+     * @brief Checks whether a directory exists.
+     */
+    bool is_dir(const std::string &path) const;
+
+    /**
+     * @brief Reads a capability node, with trailing whitespace removed.
+     *
+     * The content is recorded in the manifest, only use it for nodes that don't change after boot.
+     *
+     * @return Node content, or an empty string if it cannot be read.
+     */
+    const std::string &read(const std::string &path) const;
+
+    /**
+     * @brief Lists entries of a directory whose name matches a wildcard pattern.
+     *
+     * @param dir Directory to list.
+     * @param pattern fnmatch(3) pattern matched against entry names.
+     * @param ignore_case Match case-insensitively.
+     * @return Sorted list of matching paths.
+     */
+    const std::vector<std::string> &list(const std::string &dir, const char *pattern, bool ignore_case = false) const;
+
+    /**
+     * @brief Recursively searches a directory for the first directory matching a pattern, case-insensitively.
+     *
+     * @return Path of the first match, or an empty string if nothing matches.
+     */
+    const std::string &find_dir(const std::string &dir, const char *pattern) const;
+
+    /**
+     * @brief Expands a path whose components may hold fnmatch(3) wildcards.
+     *
+     * @return Sorted list of existing paths matching the pattern.
+     */
+    std::vector<std::string> glob(const std::string &pattern) const;
+
+    /**
+     * @brief Directories holding per-policy cpufreq nodes.
+     */
+    std::vector<std::string> cpufreq_dirs() const;
+
+    /**
+     * @brief Highest frequency listed in a frequency table node.
+     */
+    std::string max_freq(const std::string &table);
+
+    /**
+     * @brief Lowest frequency listed in a frequency table node.
+     */
+    std::string min_freq(const std::string &table);
+
+    /**
+     * @brief Middle frequency listed in a frequency table node, rounded towards the higher half.
+     */
+    std::string mid_freq(const std::string &table);
+
+    /**
+     * @brief Index of the lowest OPP in a MediaTek GPU OPP table node.
+     */
+    std::string opp_min_index(const std::string &table);
+
+    /**
+     * @brief Frequency of the highest or lowest OPP in a MediaTek GPU OPP table node.
+     */
+    std::string opp_freq(const std::string &table, bool highest);
+
+    const ProfileOptions &options() const;
+
+    /**
+     * @brief Moves the collected plan out of the builder.
+     */
+    std::vector<NodeWrite> take();
+
+private:
+    const ProfileOptions &options_;
+    FreqTableCache &freq_tables_;
+    HardwareManifest &manifest_;
+    std::vector<NodeWrite> plan_;
+    uint16_t stage_ = 0;
+};
+
+// Per-SoC tweaks, implemented in SocProfiles.cpp
+void soc_performance(PlanBuilder &plan);
+void soc_balance(PlanBuilder &plan);
+void soc_powersave(PlanBuilder &plan);
@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <EncoreLog.hpp>
+
+#include "PristineSnapshot.hpp"
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[4] = {'E', 'N', 'C', 'P'};
+constexpr uint16_t SNAPSHOT_VERSION = 1;
+
+/**
+ * @brief Header of a persisted snapshot, followed by the boot id and the records.
+ *
+ * Each record is a uint16_t permission mode, uint16_t path length and uint16_t value
+ * length, followed by the path and value bytes.
+ */
+struct SnapshotHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t boot_id_size;
+    uint32_t count;
+};
+
+/**
+ * @brief Reduces a node read to the value it accepts as input.
+ */
+std::string normalize(std::string content) {
+    content.erase(content.find_last_not_of(" \t\r\n") + 1);
+
+    // Selection nodes, e.g. "[coarse_demand] adaptive always_on" or "none [mq-deadline] kyber"
+    const size_t open = content.find('[');
+    const size_t close = content.find(']', open);
+    if (open != std::string::npos && close != std::string::npos) {
+        return content.substr(open + 1, close - open - 1);
+    }
+
+    return content;
+}
+
+template <typename T>
+void put(std::string &out, T value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+bool get(const std::string &in, size_t &pos, T &value) {
+    if (in.size() - pos < sizeof(value)) return false;
+    memcpy(&value, in.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+} // namespace
+
+PristineSnapshot::PristineSnapshot(std::string root)
+    : root_(std::move(root)) {
+}
+
+size_t PristineSnapshot::capture(const std::vector<std::string> &paths) {
+    entries_.clear();
+
+    for (const auto &path : paths) {
+        const std::string full_path = root_ + path;
+
+        struct stat st{};
+        if (stat(full_path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+
+        // Nodes are often locked read-only by an earlier run, root may still read them
+        std::ifstream file(full_path);
+        if (!file.is_open()) continue;
+
+        // Reads spanning several tokens are lists, e.g. sched_features, not a value the node accepts
+        std::string value = normalize({std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()});
+        if (value.empty() || value.find_first_of(" \t\n") != std::string::npos || value.size() > UINT16_MAX) continue;
+
+        entries_.push_back(Entry{path, std::move(value), st.st_mode & 07777});
+    }
+
+    finalize();
+    LOGD_TAG("PristineSnapshot", "Captured {} of {} nodes", entries_.size(), paths.size());
+    return entries_.size();
+}
+
+bool PristineSnapshot::load(const std::string &filename, const std::string &boot_id) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        LOGD_TAG("PristineSnapshot", "{}: {}", filename, strerror(errno));
+        return false;
+    }
+
+    const std::string data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    size_t pos = 0;
+
+    SnapshotHeader header{};
+    if (!get(data, pos, header) || memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SNAPSHOT_VERSION || data.size() - pos < header.boot_id_size) {
+        LOGW_TAG("PristineSnapshot", "{}: invalid or outdated snapshot", filename);
+        return false;
+    }
+
+    if (data.compare(pos, header.boot_id_size, boot_id) != 0 || header.boot_id_size != boot_id.size()) {
+        LOGI_TAG("PristineSnapshot", "{} belongs to an earlier boot, discarding it", filename);
+        return false;
+    }
+    pos += header.boot_id_size;
+
+    std::vector<Entry> entries;
+    entries.reserve(header.count);
+
+    for (uint32_t i = 0; i < header.count; i++) {
+        uint16_t mode = 0, path_size = 0, value_size = 0;
+        if (!get(data, pos, mode) || !get(data, pos, path_size) || !get(data, pos, value_size) ||
+            data.size() - pos < static_cast<size_t>(path_size) + value_size) {
+            LOGW_TAG("PristineSnapshot", "{}: truncated snapshot", filename);
+            return false;
+        }
+
+        entries.push_back(Entry{data.substr(pos, path_size), data.substr(pos + path_size, value_size), mode});
+        pos += path_size + value_size;
+    }
+
+    entries_ = std::move(entries);
+    finalize();
+    LOGI_TAG("PristineSnapshot", "Loaded {} pristine nodes from {}", entries_.size(), filename);
+    return true;
+}
+
+bool PristineSnapshot::save(const std::string &filename, const std::string &boot_id) const {
+    SnapshotHeader header{};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.boot_id_size = static_cast<uint16_t>(boot_id.size());
+    header.count = static_cast<uint32_t>(entries_.size());
+
+    std::string data;
+    put(data, header);
+    data += boot_id;
+
+    for (const auto &entry : entries_) {
+        put(data, static_cast<uint16_t>(entry.mode));
+        put(data, static_cast<uint16_t>(entry.path.size()));
+        put(data, static_cast<uint16_t>(entry.value.size()));
+        data += entry.path;
+        data += entry.value;
+    }
+
+    // Write to a temporary file first, a torn snapshot would lose the original values for good
+    const std::string tmp_path = filename + ".tmp";
+    std::ofstream output_file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!output_file.is_open()) {
+        LOGE_TAG("PristineSnapshot", "Failed to create {}", tmp_path);
+        return false;
+    }
+
+    output_file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    output_file.close();
+
+    if (!output_file || rename(tmp_path.c_str(), filename.c_str()) != 0) {
+        LOGE_TAG("PristineSnapshot", "Failed to write {}: {}", filename, strerror(errno));
+        unlink(tmp_path.c_str());
+        return false;
+    }
+
+    LOGD_TAG("PristineSnapshot", "Saved {} pristine nodes to {}", entries_.size(), filename);
+    return true;
+}
+
+size_t PristineSnapshot::restore() const noexcept {
+    size_t restored = 0;
+
+    for (size_t i = 0; i < entries_.size(); i++) {
+        const char *path = restore_paths_[i].c_str();
+        const std::string &data = restore_data_[i];
+
+        chmod(path, 0644);
+
+        int fd = open(path, O_WRONLY | O_TRUNC | O_CLOEXEC);
+        if (fd >= 0) {
+            if (write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size())) restored++;
+            close(fd);
+        }
+
+        chmod(path, entries_[i].mode);
+    }
+
+    return restored;
+}
+
+const std::string *PristineSnapshot::value(const std::string &path) const {
+    auto it = index_.find(path);
+    return it == index_.end() ? nullptr : &entries_[it->second].value;
+}
+
+const std::vector<PristineSnapshot::Entry> &PristineSnapshot::entries() const {
+    return entries_;
+}
+
+size_t PristineSnapshot::size() const {
+    return entries_.size();
+}
+
+bool PristineSnapshot::empty() const {
+    return entries_.empty();
+}
+
+void PristineSnapshot::finalize() {
+    index_.clear();
+    restore_paths_.clear();
+    restore_data_.clear();
+
+    for (size_t i = 0; i < entries_.size(); i++) {
+        index_.emplace(entries_[i].path, i);
+        restore_paths_.push_back(root_ + entries_[i].path);
+        restore_data_.push_back(entries_[i].value + "\n");
+    }
+}
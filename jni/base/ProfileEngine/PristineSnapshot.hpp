@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class PristineSnapshot
+ * @brief Values and permissions of every node Encore touches, as the system left them at boot.
+ *
+ * Captured before the first profile write and persisted per boot, so a restarted daemon
+ * still knows the original values after the nodes have been tweaked.
+ */
+class PristineSnapshot {
+public:
+    struct Entry {
+        std::string path;  /// Node path, relative to the root
+        std::string value; /// Original value, without trailing newline
+        mode_t mode;       /// Original permission bits
+    };
+
+    /**
+     * @param root Prefix prepended to every node path.
+     */
+    explicit PristineSnapshot(std::string root = "");
+
+    /**
+     * @brief Reads the current value and permissions of nodes.
+     *
+     * Nodes that can't be read are left out. Selection nodes such as "[a] b c" are stored
+     * as their selected entry, which is what they accept as input.
+     *
+     * @param paths Nodes to capture, in the order they should be restored.
+     * @return Number of captured nodes.
+     */
+    size_t capture(const std::vector<std::string> &paths);
+
+    /**
+     * @brief Loads a snapshot persisted by save().
+     *
+     * @param filename Snapshot file to load.
+     * @param boot_id Identity of the current boot, snapshots of an earlier boot are discarded.
+     * @return true if the snapshot was loaded, false if missing, stale or invalid.
+     */
+    bool load(const std::string &filename, const std::string &boot_id);
+
+    /**
+     * @brief Persists the snapshot.
+     *
+     * @param filename Snapshot file to write.
+     * @param boot_id Identity of the current boot.
+     * @return true on success, false otherwise.
+     */
+    bool save(const std::string &filename, const std::string &boot_id) const;
+
+    /**
+     * @brief Writes every original value and permission back.
+     *
+     * Only issues chmod(), open(), write() and close(), so it may run from a signal handler.
+     *
+     * @return Number of nodes restored.
+     */
+    size_t restore() const noexcept;
+
+    /**
+     * @brief Gets the original value of a node.
+     *
+     * @return Pointer to the value, or nullptr if the node is not part of the snapshot.
+     */
+    const std::string *value(const std::string &path) const;
+
+    const std::vector<Entry> &entries() const;
+    size_t size() const;
+    bool empty() const;
+
+private:
+    std::string root_;
+    std::vector<Entry> entries_;
+    std::vector<std::string> restore_paths_; /// Per entry, full path
+    std::vector<std::string> restore_data_;  /// Per entry, value with trailing newline
+    std::unordered_map<std::string, size_t> index_;
+
+    /**
+     * @brief Rebuilds the lookup index and the preformatted restore buffers.
+     */
+    void finalize();
+};
@@ -0,0 +1,883 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <filesystem>
+#include <fnmatch.h>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include <EncoreLog.hpp>
+
+#include "NodeHandlePool.hpp"
+#include "PlanBuilder.hpp"
+#include "PristineSnapshot.hpp"
+#include "ProfileEngine.hpp"
+#include "TweakBlob.hpp"
+#include "WorkerPool.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * @brief Outcome of a plan entry passed to execute_batch().
+ */
+enum WriteResult : uint8_t {
+    NOT_RUN = 0, ///< Skipped because the transition was preempted, the node is untouched
+    WRITTEN,
+    FAILED
+};
+
+// Libraries which get reported as max CPU capability users through sched_lib_name
+constexpr const char *SCHED_LIB_NAMES =
+    "libunity.so, libil2cpp.so, libmain.so, libUE4.so, libgodot_android.so, libgdx.so, libgdx-box2d.so, "
+    "libminecraftpe.so, libLive2DCubismCore.so, libyuzu-android.so, libryujinx.so, libcitra-android.so, "
+    "libhdr_pro_engine.so, libandroidx.graphics.path.so, libeffect.so";
+
+void change_cpu_gov(PlanBuilder &plan, const std::string &governor) {
+    if (governor.empty()) return;
+    for (const auto &dir : plan.cpufreq_dirs()) {
+        plan.write(governor, dir + "/scaling_governor");
+    }
+}
+
+void write_battery_saver(PlanBuilder &plan, bool enable) {
+    const std::string node = "/sys/module/battery_saver/parameters/enabled";
+    if (!plan.exists(node)) return;
+
+    // Some kernels expose this as an integer, others as a bool parameter
+    const std::string current = plan.read(node);
+    const bool numeric = std::any_of(current.begin(), current.end(), ::isdigit);
+    plan.apply(numeric ? (enable ? "1" : "0") : (enable ? "Y" : "N"), node);
+}
+
+void cpufreq_ppm_max_perf(PlanBuilder &plan) {
+    int cluster = 0;
+    for (const auto &path : plan.list("/sys/devices/system/cpu/cpufreq", "policy*")) {
+        const std::string cpu_maxfreq = plan.max_freq(path + "/cpuinfo_max_freq");
+        plan.write(std::to_string(cluster) + " " + cpu_maxfreq, "/proc/ppm/policy/hard_userlimit_max_cpu_freq");
+
+        const std::string cpu_minfreq =
+            plan.options().lite_mode ? plan.mid_freq(path + "/scaling_available_frequencies") : cpu_maxfreq;
+        plan.write(std::to_string(cluster) + " " + cpu_minfreq, "/proc/ppm/policy/hard_userlimit_min_cpu_freq");
+        cluster++;
+    }
+}
+
+void cpufreq_max_perf(PlanBuilder &plan) {
+    for (const auto &path : plan.cpufreq_dirs()) {
+        const std::string cpu_maxfreq = plan.max_freq(path + "/cpuinfo_max_freq");
+        plan.apply(cpu_maxfreq, path + "/scaling_max_freq");
+
+        const std::string cpu_minfreq =
+            plan.options().lite_mode ? plan.mid_freq(path + "/scaling_available_frequencies") : cpu_maxfreq;
+        plan.apply(cpu_minfreq, path + "/scaling_min_freq");
+    }
+}
+
+void cpufreq_ppm_unlock(PlanBuilder &plan) {
+    int cluster = 0;
+    for (const auto &path : plan.list("/sys/devices/system/cpu/cpufreq", "policy*")) {
+        const std::string cluster_str = std::to_string(cluster) + " ";
+        plan.write(cluster_str + plan.max_freq(path + "/cpuinfo_max_freq"), "/proc/ppm/policy/hard_userlimit_max_cpu_freq");
+        plan.write(cluster_str + plan.min_freq(path + "/cpuinfo_min_freq"), "/proc/ppm/policy/hard_userlimit_min_cpu_freq");
+        cluster++;
+    }
+}
+
+void cpufreq_unlock(PlanBuilder &plan) {
+    for (const auto &path : plan.cpufreq_dirs()) {
+        plan.write(plan.max_freq(path + "/cpuinfo_max_freq"), path + "/scaling_max_freq");
+        plan.write(plan.min_freq(path + "/cpuinfo_min_freq"), path + "/scaling_min_freq");
+    }
+}
+
+void block_queue_tweak(PlanBuilder &plan, const char *read_ahead_kb, const char *nr_requests) {
+    std::vector<std::string> devices = {"/sys/block/mmcblk0", "/sys/block/mmcblk1"};
+    for (auto &dev : plan.list("/sys/block", "sd*")) {
+        devices.push_back(std::move(dev));
+    }
+
+    for (const auto &dev : devices) {
+        // Reduce heuristic read-ahead in exchange for I/O latency
+        plan.apply(read_ahead_kb, dev + "/queue/read_ahead_kb");
+
+        // Reduce the maximum number of I/O requests in exchange for latency
+        plan.apply(nr_requests, dev + "/queue/nr_requests");
+    }
+}
+
+void touchpanel_game_mode(PlanBuilder &plan, bool enable) {
+    // Oppo/Oplus/Realme Touchpanel
+    const std::string tp_path = "/proc/touchpanel";
+    if (!plan.is_dir(tp_path)) return;
+
+    plan.apply(enable ? "1" : "0", tp_path + "/game_switch_enable");
+    plan.apply(enable ? "0" : "1", tp_path + "/oplus_tp_limit_enable");
+    plan.apply(enable ? "0" : "1", tp_path + "/oppo_tp_limit_enable");
+    plan.apply(enable ? "1" : "0", tp_path + "/oplus_tp_direction");
+    plan.apply(enable ? "1" : "0", tp_path + "/oppo_tp_direction");
+}
+
+void perfcommon(PlanBuilder &plan) {
+    // Disable Kernel panic
+    // Workaround for kernel panic on startup in S25U.
+    plan.apply("0", "/proc/sys/kernel/panic");
+    plan.apply("0", "/proc/sys/kernel/panic_on_oops");
+    plan.apply("0", "/proc/sys/kernel/panic_on_warn");
+    plan.apply("0", "/proc/sys/kernel/softlockup_panic");
+
+    // I/O Tweaks
+    for (const auto &dir : plan.list("/sys/block", "*")) {
+        // Disable I/O statistics accounting
+        plan.apply("0", dir + "/queue/iostats");
+
+        // Don't use I/O as random spice
+        plan.apply("0", dir + "/queue/add_random");
+    }
+
+    // Networking tweaks, pick the first available congestion algorithm
+    std::istringstream available(plan.read("/proc/sys/net/ipv4/tcp_available_congestion_control"));
+    std::vector<std::string> algorithms{std::istream_iterator<std::string>(available), {}};
+    for (const char *algo : {"bbr3", "bbr2", "bbrplus", "bbr", "westwood", "cubic"}) {
+        if (std::find(algorithms.begin(), algorithms.end(), algo) != algorithms.end()) {
+            plan.apply(algo, "/proc/sys/net/ipv4/tcp_congestion_control");
+            break;
+        }
+    }
+
+    plan.apply("1", "/proc/sys/net/ipv4/tcp_low_latency");
+    plan.apply("1", "/proc/sys/net/ipv4/tcp_ecn");
+    plan.apply("3", "/proc/sys/net/ipv4/tcp_fastopen");
+    plan.apply("1", "/proc/sys/net/ipv4/tcp_sack");
+    plan.apply("0", "/proc/sys/net/ipv4/tcp_timestamps");
+
+    // Limit max perf event processing time to this much CPU usage
+    plan.apply("3", "/proc/sys/kernel/perf_cpu_time_max_percent");
+
+    // Disable schedstats
+    plan.apply("0", "/proc/sys/kernel/sched_schedstats");
+
+    // Disable Oppo/Realme cpustats
+    plan.apply("0", "/proc/sys/kernel/task_cpustats_enable");
+
+    // Disable Sched auto group
+    plan.apply("0", "/proc/sys/kernel/sched_autogroup_enabled");
+
+    // Enable CRF
+    plan.apply("1", "/proc/sys/kernel/sched_child_runs_first");
+
+    // Improve real time latencies by reducing the scheduler migration time
+    plan.apply("32", "/proc/sys/kernel/sched_nr_migrate");
+
+    // Tweaking scheduler to reduce latency
+    plan.apply("50000", "/proc/sys/kernel/sched_migration_cost_ns");
+    plan.apply("1000000", "/proc/sys/kernel/sched_min_granularity_ns");
+    plan.apply("1500000", "/proc/sys/kernel/sched_wakeup_granularity_ns");
+
+    // Disable read-ahead for swap devices
+    plan.apply("0", "/proc/sys/vm/page-cluster");
+
+    // Update /proc/stat less often to reduce jitter
+    plan.apply("15", "/proc/sys/vm/stat_interval");
+
+    // Disable compaction_proactiveness
+    plan.apply("0", "/proc/sys/vm/compaction_proactiveness");
+
+    // Disable SPI CRC
+    plan.apply("0", "/sys/module/mmc_core/parameters/use_spi_crc");
+
+    // Disable OnePlus opchain
+    plan.apply("0", "/sys/module/opchain/parameters/chain_on");
+
+    // Disable Oplus bloats
+    plan.apply("0", "/sys/module/cpufreq_bouncing/parameters/enable");
+    plan.apply("0", "/proc/task_info/task_sched_info/task_sched_info_enable");
+    plan.apply("0", "/proc/oplus_scheduler/sched_assist/sched_assist_enabled");
+
+    // Report max CPU capabilities to these libraries
+    plan.apply(SCHED_LIB_NAMES, "/proc/sys/kernel/sched_lib_name");
+    plan.apply("255", "/proc/sys/kernel/sched_lib_mask_force");
+
+    // Set thermal governor to step_wise
+    for (const auto &dir : plan.list("/sys/class/thermal", "thermal_zone*")) {
+        plan.apply("step_wise", dir + "/policy");
+    }
+}
+
+void performance_profile(PlanBuilder &plan) {
+    const auto &options = plan.options();
+
+    // Disable battery saver module
+    write_battery_saver(plan, false);
+
+    // Disable split lock mitigation
+    plan.apply("0", "/proc/sys/kernel/split_lock_mitigate");
+
+    if (plan.exists("/sys/kernel/debug/sched_features")) {
+        // Consider scheduling tasks that are eager to run
+        plan.apply("NEXT_BUDDY", "/sys/kernel/debug/sched_features");
+
+        // Some sources report large latency spikes during large migrations
+        plan.apply("NO_TTWU_QUEUE", "/sys/kernel/debug/sched_features");
+    }
+
+    if (plan.is_dir("/dev/stune")) {
+        // Prefer to schedule top-app tasks on idle CPUs
+        plan.apply("1", "/dev/stune/top-app/schedtune.prefer_idle");
+
+        // Mark top-app as boosted, find high-performing CPUs
+        plan.apply("1", "/dev/stune/top-app/schedtune.boost");
+    }
+
+    touchpanel_game_mode(plan, true);
+
+    // Memory tweak
+    plan.apply("80", "/proc/sys/vm/vfs_cache_pressure");
+
+    // Set CPU governor to performance.
+    // If lite mode enabled, use the default governor instead.
+    // device mitigation also will prevent performance gov to be
+    // applied (some device hates performance governor).
+    if (!options.lite_mode && !options.no_performance_cpugov) {
+        change_cpu_gov(plan, "performance");
+    } else {
+        change_cpu_gov(plan, options.balance_cpugov);
+    }
+
+    // Force CPU to highest possible frequency.
+    if (plan.is_dir("/proc/ppm")) {
+        cpufreq_ppm_max_perf(plan);
+    } else {
+        cpufreq_max_perf(plan);
+    }
+
+    block_queue_tweak(plan, "32", "32");
+
+    soc_performance(plan);
+
+    // Drop caches once every tweak is in place
+    plan.barrier();
+    plan.raw("3", "/proc/sys/vm/drop_caches");
+}
+
+void balance_profile(PlanBuilder &plan) {
+    // Disable battery saver module
+    write_battery_saver(plan, false);
+
+    // Enable split lock mitigation
+    plan.apply("1", "/proc/sys/kernel/split_lock_mitigate");
+
+    if (plan.exists("/sys/kernel/debug/sched_features")) {
+        // Consider scheduling tasks that are eager to run
+        plan.apply("NEXT_BUDDY", "/sys/kernel/debug/sched_features");
+
+        // Schedule tasks on their origin CPU if possible
+        plan.apply("TTWU_QUEUE", "/sys/kernel/debug/sched_features");
+    }
+
+    if (plan.is_dir("/dev/stune")) {
+        // We are not concerned with prioritizing latency
+        plan.apply("0", "/dev/stune/top-app/schedtune.prefer_idle");
+
+        // Don't boost foreground tasks, let the governor handle it
+        plan.apply("0", "/dev/stune/top-app/schedtune.boost");
+    }
+
+    touchpanel_game_mode(plan, false);
+
+    // Memory Tweaks
+    plan.apply("120", "/proc/sys/vm/vfs_cache_pressure");
+
+    // Restore min CPU frequency
+    change_cpu_gov(plan, plan.options().balance_cpugov);
+
+    if (plan.is_dir("/proc/ppm")) {
+        cpufreq_ppm_unlock(plan);
+    } else {
+        cpufreq_unlock(plan);
+    }
+
+    block_queue_tweak(plan, "128", "64");
+
+    soc_balance(plan);
+}
+
+void powersave_profile(PlanBuilder &plan) {
+    balance_profile(plan);
+
+    // Allow cores to go idle, we are not concerned with prioritizing latency
+    if (plan.is_dir("/dev/stune")) {
+        plan.apply("1", "/dev/stune/top-app/schedtune.prefer_idle");
+    }
+
+    // Enable battery saver module
+    write_battery_saver(plan, true);
+
+    // CPU governor
+    change_cpu_gov(plan, plan.options().powersave_cpugov);
+
+    soc_powersave(plan);
+}
+
+} // namespace
+
+// =============================================================================
+// PlanBuilder
+// =============================================================================
+
+PlanBuilder::PlanBuilder(const ProfileOptions &options, FreqTableCache &freq_tables, HardwareManifest &manifest)
+    : options_(options)
+    , freq_tables_(freq_tables)
+    , manifest_(manifest) {
+}
+
+void PlanBuilder::apply(std::string_view value, const std::string &path) {
+    push(value, path, WriteMode::Apply);
+}
+
+void PlanBuilder::write(std::string_view value, const std::string &path) {
+    push(value, path, WriteMode::Write);
+}
+
+void PlanBuilder::raw(std::string_view value, const std::string &path) {
+    push(value, path, WriteMode::Raw);
+}
+
+bool PlanBuilder::exists(const std::string &path) const {
+    return manifest_.is_file(path);
+}
+
+bool PlanBuilder::is_dir(const std::string &path) const {
+    return manifest_.is_dir(path);
+}
+
+const std::string &PlanBuilder::read(const std::string &path) const {
+    return manifest_.read(path);
+}
+
+const std::vector<std::string> &PlanBuilder::list(const std::string &dir, const char *pattern, bool ignore_case) const {
+    return manifest_.list(dir, pattern, ignore_case);
+}
+
+const std::string &PlanBuilder::find_dir(const std::string &dir, const char *pattern) const {
+    return manifest_.find_dir(dir, pattern);
+}
+
+std::vector<std::string> PlanBuilder::glob(const std::string &pattern) const {
+    std::vector<std::string> matches = {""};
+    size_t pos = 1;
+
+    while (pos <= pattern.size() && !matches.empty()) {
+        size_t next = pattern.find('/', pos);
+        if (next == std::string::npos) next = pattern.size();
+
+        const std::string component = pattern.substr(pos, next - pos);
+        std::vector<std::string> expanded;
+
+        for (const auto &base : matches) {
+            if (component.find_first_of("*?[") == std::string::npos) {
+                expanded.push_back(base + "/" + component);
+            } else {
+                for (const auto &path : list(base.empty() ? "/" : base, component.c_str())) {
+                    // list() joins with '/', avoid a double slash below the root
+                    expanded.push_back(base.empty() ? path.substr(1) : path);
+                }
+            }
+        }
+
+        matches = std::move(expanded);
+        pos = next + 1;
+    }
+
+    std::erase_if(matches, [this](const std::string &path) {
+        return !exists(path) && !is_dir(path);
+    });
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+std::vector<std::string> PlanBuilder::cpufreq_dirs() const {
+    // Per-CPU cpufreq directories are symlinks into the policy directories,
+    // use the policies directly when the kernel exposes them.
+    auto dirs = list("/sys/devices/system/cpu/cpufreq", "policy*");
+    if (!dirs.empty()) return dirs;
+
+    for (const auto &cpu : list("/sys/devices/system/cpu", "cpu[0-9]*")) {
+        if (is_dir(cpu + "/cpufreq")) dirs.push_back(cpu + "/cpufreq");
+    }
+    return dirs;
+}
+
+std::string PlanBuilder::max_freq(const std::string &table) {
+    const auto &freqs = freq_tables_.table(table);
+    return freqs.empty() ? "" : std::to_string(freqs.max());
+}
+
+std::string PlanBuilder::min_freq(const std::string &table) {
+    const auto &freqs = freq_tables_.table(table);
+    return freqs.empty() ? "" : std::to_string(freqs.min());
+}
+
+std::string PlanBuilder::mid_freq(const std::string &table) {
+    const auto &freqs = freq_tables_.table(table);
+    return freqs.empty() ? "" : std::to_string(freqs.mid());
+}
+
+std::string PlanBuilder::opp_min_index(const std::string &table) {
+    return freq_tables_.opp_table(table).last_index();
+}
+
+std::string PlanBuilder::opp_freq(const std::string &table, bool highest) {
+    const uint64_t freq = freq_tables_.opp_table(table).edge_freq(highest);
+    return freq == 0 ? "" : std::to_string(freq);
+}
+
+const ProfileOptions &PlanBuilder::options() const {
+    return options_;
+}
+
+std::vector<NodeWrite> PlanBuilder::take() {
+    return std::move(plan_);
+}
+
+void PlanBuilder::barrier() {
+    if (!plan_.empty() && plan_.back().stage == stage_) stage_++;
+}
+
+void PlanBuilder::push(std::string_view value, const std::string &path, WriteMode mode) {
+    if (value.empty() || !exists(path)) return;
+    plan_.push_back(NodeWrite{path, std::string(value), mode, stage_});
+}
+
+// =============================================================================
+// ProfileEngine
+// =============================================================================
+
+ProfileEngine::ProfileEngine(std::string root)
+    : root_(std::move(root))
+    , freq_tables_(root_)
+    , manifest_(root_)
+    , handles_(std::make_unique<NodeHandlePool>()) {
+}
+
+ProfileEngine::~ProfileEngine() = default;
+
+size_t ProfileEngine::apply(EncoreProfileMode mode, const ProfileOptions &options) {
+    // Sync to data in the rare case a device crashes
+    if (mode == PERFCOMMON) sync();
+
+    const auto plan = build_plan(mode, options);
+    const auto keys = diff_keys(plan);
+    std::vector<size_t> pending;
+    size_t written = 0, unchanged = 0;
+
+    for (size_t i = 0; i < plan.size(); i++) {
+        if (!keys[i].empty()) {
+            auto it = node_state_.find(keys[i]);
+            if (it != node_state_.end() && it->second == plan[i].value) {
+                unchanged++;
+                continue;
+            }
+        }
+        pending.push_back(i);
+    }
+
+    // Perfcommon runs once, don't hold its nodes open
+    const auto results = execute_batch(plan, pending, mode != PERFCOMMON, mode != PERFCOMMON);
+    size_t skipped = 0;
+
+    for (size_t i : pending) {
+        // Skipped nodes still hold what the engine remembers for them
+        if (results[i] == NOT_RUN) {
+            skipped++;
+            continue;
+        }
+
+        if (results[i] == WRITTEN) written++;
+        record(keys[i], plan[i], results[i] == WRITTEN);
+    }
+
+    preempted_ = skipped > 0;
+    if (preempted_) {
+        LOGD_TAG(
+            "ProfileEngine", "Profile {} preempted, {} nodes written, {} skipped", static_cast<int>(mode), written,
+            skipped);
+        return written + unchanged;
+    }
+
+    LOGD_TAG(
+        "ProfileEngine", "Profile {} applied, {} nodes written, {} unchanged, {} total", static_cast<int>(mode),
+        written, unchanged, plan.size());
+    return written + unchanged;
+}
+
+std::vector<NodeWrite> ProfileEngine::diff_plan(const std::vector<NodeWrite> &plan) const {
+    const auto keys = diff_keys(plan);
+    std::vector<NodeWrite> result;
+
+    for (size_t i = 0; i < plan.size(); i++) {
+        if (!keys[i].empty()) {
+            auto it = node_state_.find(keys[i]);
+            if (it != node_state_.end() && it->second == plan[i].value) continue;
+        }
+        result.push_back(plan[i]);
+    }
+
+    return result;
+}
+
+void ProfileEngine::invalidate() {
+    node_state_.clear();
+    handles_->close_all();
+}
+
+std::vector<std::vector<NodeWrite>> ProfileEngine::build_all_variants(const ProfileOptions &options) {
+    std::vector<std::vector<NodeWrite>> plans;
+    ProfileOptions variant = options;
+
+    for (unsigned combo = 0; combo < 16; combo++) {
+        variant.lite_mode = combo & 1;
+        variant.disable_ddr_tweak = combo & 2;
+        variant.no_performance_cpugov = combo & 4;
+        variant.qcom_no_gpu_powersave = combo & 8;
+        for (auto mode : {PERFCOMMON, PERFORMANCE_PROFILE, BALANCE_PROFILE, POWERSAVE_PROFILE}) {
+            plans.push_back(build_plan(mode, variant));
+        }
+    }
+
+    return plans;
+}
+
+void ProfileEngine::discover(const ProfileOptions &options) {
+    // Walk every profile under every option combination, so each node it probes
+    // and each table it consults gets recorded, whatever the user toggles later
+    build_all_variants(options);
+
+    LOGD_TAG(
+        "ProfileEngine", "Discovered {} capability probes and {} frequency tables", manifest_.size(),
+        freq_tables_.size());
+}
+
+std::vector<std::string> ProfileEngine::snapshot_nodes(const ProfileOptions &options) {
+    std::vector<std::string> nodes;
+    std::unordered_set<std::string> seen, excluded;
+
+    for (const auto &plan : build_all_variants(options)) {
+        std::unordered_map<std::string_view, size_t> occurrences;
+        for (const auto &node : plan) {
+            occurrences[node.path]++;
+        }
+
+        for (const auto &node : plan) {
+            const bool command = occurrences[node.path] > 1 && node.value.find(' ') != std::string::npos;
+            if (node.mode == WriteMode::Raw || command) {
+                excluded.insert(node.path);
+            } else if (seen.insert(node.path).second) {
+                nodes.push_back(node.path);
+            }
+        }
+    }
+
+    std::erase_if(nodes, [&excluded](const std::string &path) { return excluded.contains(path); });
+    return nodes;
+}
+
+void ProfileEngine::set_pristine(const PristineSnapshot *snapshot, const ProfileOptions &options) {
+    pristine_ = nullptr;
+    baseline_nodes_.clear();
+    if (!snapshot) return;
+
+    for (auto &node : build_plan(PERFCOMMON, options)) {
+        baseline_nodes_.insert(std::move(node.path));
+    }
+    pristine_ = snapshot;
+}
+
+void ProfileEngine::append_pristine_restore(std::vector<NodeWrite> &plan) const {
+    // Reserve first, the views below must survive the appends
+    plan.reserve(plan.size() + pristine_->size());
+    std::unordered_set<std::string_view> written;
+    for (const auto &node : plan) {
+        written.insert(node.path);
+    }
+
+    // Disjoint from every node of the plan, no ordering needed
+    const uint16_t stage = plan.empty() ? 0 : plan.back().stage;
+    const size_t size = plan.size();
+    for (const auto &entry : pristine_->entries()) {
+        if (written.contains(entry.path) || baseline_nodes_.contains(entry.path)) continue;
+        // Written, not locked, so the node stays as writable as the system left it
+        plan.push_back(NodeWrite{entry.path, entry.value, WriteMode::Write, stage});
+    }
+
+    LOGT_TAG("ProfileEngine", "{} nodes restored to their pristine value", plan.size() - size);
+}
+
+bool ProfileEngine::load_tweaks(const std::string &path) {
+    tweaks_ = TweakBlob::open(path);
+    tweak_paths_.clear();
+    return tweaks_ != nullptr;
+}
+
+void ProfileEngine::append_declared_tweaks(PlanBuilder &plan, EncoreProfileMode mode) {
+    const auto &options = plan.options();
+    const uint8_t flags = (options.lite_mode ? TWEAK_FLAG_LITE_MODE : 0) |
+                          (options.disable_ddr_tweak ? TWEAK_FLAG_DISABLE_DDR_TWEAK : 0) |
+                          (options.no_performance_cpugov ? TWEAK_FLAG_NO_PERFORMANCE_CPUGOV : 0) |
+                          (options.qcom_no_gpu_powersave ? TWEAK_FLAG_QCOM_NO_GPU_POWERSAVE : 0);
+    const auto soc_bit = static_cast<uint16_t>(1 << static_cast<int>(options.soc));
+
+    // Declared tweaks override the built-in ones, write them last
+    plan.barrier();
+
+    for (size_t i = 0; i < tweaks_->size(); i++) {
+        const TweakEntry &entry = tweaks_->entry(i);
+
+        if (!(entry.profiles & (1 << mode))) continue;
+        if (entry.soc_mask && !(entry.soc_mask & soc_bit)) continue;
+        if ((flags & entry.require) != entry.require || (flags & entry.forbid)) continue;
+
+        // Node layout doesn't change at runtime, expand each pattern once
+        auto it = tweak_paths_.find(entry.path);
+        if (it == tweak_paths_.end()) {
+            it = tweak_paths_.emplace(entry.path, plan.glob(tweaks_->string(entry.path))).first;
+        }
+
+        const std::string operand = tweaks_->string(entry.value);
+        const auto kind = static_cast<TweakValue>(entry.value_kind);
+
+        for (const auto &path : it->second) {
+            std::string value = operand;
+
+            if (kind != TweakValue::Literal) {
+                // Relative tables are looked up next to the node
+                const std::string table = operand.starts_with('/') ? operand : path.substr(0, path.rfind('/') + 1) + operand;
+                switch (kind) {
+                    case TweakValue::TableMax: value = plan.max_freq(table); break;
+                    case TweakValue::TableMid: value = plan.mid_freq(table); break;
+                    case TweakValue::TableMin: value = plan.min_freq(table); break;
+                    default: break;
+                }
+                if (value.empty()) continue;
+            }
+
+            plan.push(value, path, static_cast<WriteMode>(entry.mode));
+        }
+    }
+}
+
+void ProfileEngine::set_preempt(std::function<bool()> check) {
+    preempt_ = std::move(check);
+}
+
+bool ProfileEngine::preempted() const {
+    return preempted_;
+}
+
+void ProfileEngine::set_parallelism(size_t lanes) {
+    lanes_ = std::max<size_t>(lanes, 1);
+    workers_.reset();
+}
+
+FreqTableCache &ProfileEngine::freq_tables() {
+    return freq_tables_;
+}
+
+HardwareManifest &ProfileEngine::manifest() {
+    return manifest_;
+}
+
+std::vector<NodeWrite> ProfileEngine::build_plan(EncoreProfileMode mode, const ProfileOptions &options) {
+    PlanBuilder plan(options, freq_tables_, manifest_);
+
+    switch (mode) {
+        case PERFCOMMON: perfcommon(plan); break;
+        case PERFORMANCE_PROFILE: performance_profile(plan); break;
+        case BALANCE_PROFILE: balance_profile(plan); break;
+        case POWERSAVE_PROFILE: powersave_profile(plan); break;
+    }
+
+    if (tweaks_) append_declared_tweaks(plan, mode);
+
+    auto writes = plan.take();
+    if (pristine_ && (mode == BALANCE_PROFILE || mode == POWERSAVE_PROFILE)) append_pristine_restore(writes);
+
+    return writes;
+}
+
+const std::string &ProfileEngine::root() const {
+    return root_;
+}
+
+bool ProfileEngine::execute(const NodeWrite &node, bool pooled) {
+    const std::string path = root_ + node.path;
+    const std::string data = node.value + "\n";
+
+    if (pooled) {
+        const bool ok = handles_->write(path, data, node.mode);
+        if (!ok) {
+            LOGT_TAG("ProfileEngine", "write '{}' to {} failed: {}", node.value, node.path, strerror(errno));
+        }
+        return ok;
+    }
+
+    if (node.mode != WriteMode::Raw) chmod(path.c_str(), 0644);
+
+    int fd = open(path.c_str(), O_WRONLY | O_TRUNC | O_CLOEXEC);
+    if (fd < 0) {
+        LOGT_TAG("ProfileEngine", "open {} failed: {}", node.path, strerror(errno));
+        return false;
+    }
+
+    const bool ok = ::write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+    if (!ok) {
+        LOGT_TAG("ProfileEngine", "write '{}' to {} failed: {}", node.value, node.path, strerror(errno));
+    }
+    close(fd);
+
+    if (node.mode == WriteMode::Apply) chmod(path.c_str(), 0444);
+    return ok;
+}
+
+std::vector<uint8_t> ProfileEngine::execute_batch(
+    const std::vector<NodeWrite> &plan, const std::vector<size_t> &pending, bool pooled, bool preemptible) {
+    std::vector<uint8_t> results(plan.size(), NOT_RUN);
+    size_t begin = 0;
+
+    // The check is only polled by the applying thread, workers just observe the outcome
+    const auto caller = std::this_thread::get_id();
+    std::atomic<bool> stop{false};
+    auto poll_preempt = [&]() {
+        if (!preemptible || !preempt_) return false;
+        if (!stop.load(std::memory_order_relaxed) && std::this_thread::get_id() == caller && preempt_()) {
+            stop.store(true, std::memory_order_relaxed);
+        }
+        return stop.load(std::memory_order_relaxed);
+    };
+
+    while (begin < pending.size() && !poll_preempt()) {
+        // Collect one stage, grouped by node directory in order of first appearance
+        const uint16_t stage = plan[pending[begin]].stage;
+        std::vector<std::vector<size_t>> groups;
+        std::unordered_map<std::string_view, size_t> group_of;
+
+        size_t end = begin;
+        for (; end < pending.size() && plan[pending[end]].stage == stage; end++) {
+            const std::string &path = plan[pending[end]].path;
+            const std::string_view dir(path.data(), path.rfind('/'));
+
+            auto [it, inserted] = group_of.try_emplace(dir, groups.size());
+            if (inserted) groups.emplace_back();
+            groups[it->second].push_back(pending[end]);
+        }
+
+        // A directory is written as a whole, so its nodes never end up half way between profiles
+        auto run_group = [&](size_t group) {
+            if (poll_preempt()) return;
+            for (size_t i : groups[group]) {
+                results[i] = execute(plan[i], pooled) ? WRITTEN : FAILED;
+            }
+        };
+
+        if (lanes_ > 1 && groups.size() > 1) {
+            if (!workers_) workers_ = std::make_unique<WorkerPool>(lanes_ - 1);
+            workers_->run(groups.size(), run_group);
+        } else {
+            for (size_t group = 0; group < groups.size(); group++) run_group(group);
+        }
+
+        begin = end;
+    }
+
+    return results;
+}
+
+std::vector<std::string> ProfileEngine::diff_keys(const std::vector<NodeWrite> &plan) {
+    std::unordered_map<std::string_view, size_t> occurrences;
+    for (const auto &node : plan) {
+        occurrences[node.path]++;
+    }
+
+    std::vector<std::string> keys;
+    keys.reserve(plan.size());
+
+    for (const auto &node : plan) {
+        // Only locked nodes are ours, anything left writable may be changed by others
+        if (node.mode != WriteMode::Apply) {
+            keys.emplace_back();
+            continue;
+        }
+
+        if (occurrences[node.path] == 1) {
+            keys.push_back(node.path);
+            continue;
+        }
+
+        // Command-style node, e.g. "ignore_batt_oc 1" or "0 2000000"
+        const auto space = node.value.find(' ');
+        if (space == std::string::npos || space == 0) {
+            keys.emplace_back();
+            continue;
+        }
+
+        keys.push_back(node.path + " " + node.value.substr(0, space));
+    }
+
+    return keys;
+}
+
+void ProfileEngine::record(const std::string &key, const NodeWrite &node, bool ok) {
+    if (key.empty() || key == node.path) {
+        // A plain write may have changed what any sub-key of the node holds
+        std::erase_if(node_state_, [&node](const auto &entry) {
+            return entry.first.size() > node.path.size() && entry.first.starts_with(node.path) &&
+                   entry.first[node.path.size()] == ' ';
+        });
+    } else {
+        node_state_.erase(node.path);
+    }
+
+    if (key.empty()) {
+        node_state_.erase(node.path);
+        return;
+    }
+
+    if (ok) {
+        node_state_[key] = node.value;
+    } else {
+        node_state_.erase(key);
+    }
+}
+
+SocVendor read_soc_vendor(const std::string &path) {
+    std::ifstream file(path);
+    int soc = 0;
+    if (!(file >> soc) || soc < 0 || soc > static_cast<int>(SocVendor::Kirin)) {
+        return SocVendor::Unknown;
+    }
+    return static_cast<SocVendor>(soc);
+}
@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <Encore.hpp>
+#include <HardwareManifest.hpp>
+
+#include "FreqTable.hpp"
+
+/**
+ * @brief SoC vendor as recognized by customize.sh and stored in SOC_RECOGNITION_FILE.
+ */
+enum class SocVendor : int {
+    Unknown = 0,
+    MediaTek = 1,
+    Snapdragon = 2,
+    Exynos = 3,
+    Unisoc = 4,
+    Tensor = 5,
+    Tegra = 6,
+    Kirin = 7
+};
+
+/**
+ * @brief How a node is written, matches apply() and write() of the old profiler script.
+ */
+enum class WriteMode : uint8_t {
+    Apply, ///< Unlock, write and lock the node read-only afterwards
+    Write, ///< Unlock and write, leaving the node writable
+    Raw    ///< Plain write without touching permissions
+};
+
+/**
+ * @brief A single sysfs/procfs write issued by a profile.
+ */
+struct NodeWrite {
+    std::string path;  /// Node path, relative to the engine root
+    std::string value; /// Value to write, without trailing newline
+    WriteMode mode;    /// Permission handling around the write
+    uint16_t stage;    /// Writes of a stage only start after every earlier stage completed
+};
+
+/**
+ * @brief Inputs that select which tweaks a profile applies.
+ */
+struct ProfileOptions {
+    SocVendor soc = SocVendor::Unknown;
+    bool lite_mode = false;
+    bool disable_ddr_tweak = false;     /// DISABLE_DDR_TWEAK mitigation
+    bool no_performance_cpugov = false; /// NO_PERFORMANCE_CPUGOV mitigation
+    bool qcom_no_gpu_powersave = false; /// QCOM_NO_GPU_POWERSAVE mitigation
+    std::string balance_cpugov;
+    std::string powersave_cpugov;
+};
+
+class PlanBuilder;
+class NodeHandlePool;
+class PristineSnapshot;
+class TweakBlob;
+class WorkerPool;
+
+/**
+ * @class ProfileEngine
+ * @brief Applies Encore profiles by writing kernel tunables directly, without spawning a shell.
+ *
+ * A profile is first built into a list of NodeWrite entries and then executed.
+ * Every path is resolved against a root prefix, which is empty on a real device.
+ *
+ * Writes to nodes of the same directory (a cpufreq policy, a devfreq device, ...) keep their
+ * plan order, e.g. governor before frequency and max before min. Independent directories are
+ * written concurrently on a small worker pool, with plan stages acting as ordering barriers.
+ *
+ * The engine remembers the last value it locked into each node, so a transition only
+ * writes the nodes whose target value differs from what the outgoing profile left behind.
+ * With a pristine snapshot attached, balance and powersave put every node they don't set
+ * themselves back to its boot value, so nothing the performance profile touched lingers.
+ *
+ * Transitions may be preempted: once a newer target is pending, the engine stops issuing
+ * writes for the stale profile. Only the writes that ran are remembered, so applying the new
+ * target converges from whatever state the nodes were left in.
+ * Not thread-safe, callers must serialize profile application.
+ */
+class ProfileEngine {
+public:
+    /**
+     * @brief Constructs a profile engine.
+     *
+     * @param root Prefix prepended to every node path, e.g. a fake sysfs tree. Empty for the real one.
+     */
+    explicit ProfileEngine(std::string root = "");
+    ~ProfileEngine();
+
+    /**
+     * @brief Builds and applies a profile, skipping nodes that already hold their target value.
+     *
+     * @param mode Profile to apply.
+     * @param options Tweak selection for the profile.
+     * @return Number of nodes written successfully, or skipped because they were up to date.
+     */
+    size_t apply(EncoreProfileMode mode, const ProfileOptions &options);
+
+    /**
+     * @brief Sets the check polled while a profile is applied, perfcommon is never preempted.
+     *
+     * @param check Returns true once a newer target profile is pending. Only called from the
+     *              thread running apply(), between node directories.
+     */
+    void set_preempt(std::function<bool()> check);
+
+    /**
+     * @brief Whether the last apply() was cut short by the preempt check.
+     */
+    bool preempted() const;
+
+    /**
+     * @brief Reduces a plan to the writes that change a node compared to the last applied values.
+     *
+     * @param plan Full plan as returned by build_plan().
+     * @return Ordered subset of the plan that needs to be executed.
+     */
+    std::vector<NodeWrite> diff_plan(const std::vector<NodeWrite> &plan) const;
+
+    /**
+     * @brief Forgets every remembered node value and closes pooled node handles,
+     *        the next apply() writes the full plan.
+     *
+     * Needed whenever nodes may have been changed behind the engine's back.
+     */
+    void invalidate();
+
+    /**
+     * @brief Builds the ordered list of writes for a profile without applying it.
+     *
+     * @param mode Profile to build.
+     * @param options Tweak selection for the profile.
+     * @return Ordered list of node writes.
+     */
+    std::vector<NodeWrite> build_plan(EncoreProfileMode mode, const ProfileOptions &options);
+
+    /**
+     * @brief Records every node probed and parses every frequency table consulted by any profile,
+     *        so transitions don't have to.
+     *
+     * @param options Tweak selection used to walk the profiles, every lite mode and mitigation
+     *                combination is covered.
+     */
+    void discover(const ProfileOptions &options);
+
+    /**
+     * @brief Lists every node a pristine snapshot has to cover, in the order profiles write them.
+     *
+     * Trigger nodes written without permission handling and command-style nodes such as
+     * "<cluster> <freq>" are left out, their reads don't reflect what they accept.
+     *
+     * @param options Tweak selection used to walk the profiles, every combination is covered.
+     */
+    std::vector<std::string> snapshot_nodes(const ProfileOptions &options);
+
+    /**
+     * @brief Attaches the original node values balance and powersave restore.
+     *
+     * @param snapshot Pristine snapshot, must outlive the engine. nullptr detaches it.
+     * @param options Tweak selection, nodes set by perfcommon keep their perfcommon value.
+     */
+    void set_pristine(const PristineSnapshot *snapshot, const ProfileOptions &options);
+
+    /**
+     * @brief Gets the frequency table cache, e.g. to load or persist it.
+     */
+    FreqTableCache &freq_tables();
+
+    /**
+     * @brief Gets the hardware manifest answering node probes, e.g. to load or persist it.
+     */
+    HardwareManifest &manifest();
+
+    /**
+     * @brief Maps compiled declarative tweaks, appended to every matching profile.
+     *
+     * @param path Blob produced by compile_tweaks().
+     * @return true if the blob was mapped, false if it is missing or invalid.
+     */
+    bool load_tweaks(const std::string &path);
+
+    /**
+     * @brief Sets how many node directories may be written at once.
+     *
+     * @param lanes Number of concurrent writers, 1 executes every plan sequentially.
+     */
+    void set_parallelism(size_t lanes);
+
+    /**
+     * @brief Gets the root prefix used by this engine.
+     */
+    const std::string &root() const;
+
+private:
+    std::string root_;
+    FreqTableCache freq_tables_;
+    HardwareManifest manifest_;
+    std::unique_ptr<NodeHandlePool> handles_;
+    std::unique_ptr<WorkerPool> workers_; /// Spawned on first use, so it survives daemon()
+    std::unique_ptr<TweakBlob> tweaks_;
+    std::unordered_map<uint32_t, std::vector<std::string>> tweak_paths_; /// Path pattern offset -> matching nodes
+    size_t lanes_ = 4;
+    std::function<bool()> preempt_;
+    bool preempted_ = false;
+    std::unordered_map<std::string, std::string> node_state_; /// Diff key -> last locked value
+    const PristineSnapshot *pristine_ = nullptr;
+    std::unordered_set<std::string> baseline_nodes_; /// Nodes owned by perfcommon, never restored
+
+    /**
+     * @brief Builds every profile under every lite mode and mitigation combination.
+     */
+    std::vector<std::vector<NodeWrite>> build_all_variants(const ProfileOptions &options);
+
+    /**
+     * @brief Appends a pristine value write for each snapshot node the plan doesn't set.
+     */
+    void append_pristine_restore(std::vector<NodeWrite> &plan) const;
+
+    /**
+     * @brief Appends the declared tweaks matching a profile to a plan.
+     */
+    void append_declared_tweaks(PlanBuilder &plan, EncoreProfileMode mode);
+
+    /**
+     * @brief Computes the diff key of every write in a plan.
+     *
+     * Nodes written once are keyed by path. Command-style nodes written several times,
+     * such as "<cluster> <freq>" on PPM, are keyed by path and their first token.
+     * An empty key marks a write that cannot be diffed and always has to be executed.
+     */
+    static std::vector<std::string> diff_keys(const std::vector<NodeWrite> &plan);
+
+    /**
+     * @brief Updates the remembered node values after executing a write.
+     */
+    void record(const std::string &key, const NodeWrite &node, bool ok);
+
+    /**
+     * @brief Performs a single node write.
+     *
+     * @param node Write to perform.
+     * @param pooled Keep the node open for later transitions, false for one-off writes.
+     * @return true if the value was written, false otherwise.
+     */
+    bool execute(const NodeWrite &node, bool pooled);
+
+    /**
+     * @brief Executes a set of plan entries, grouped by stage and node directory.
+     *
+     * @param plan Full plan.
+     * @param pending Indices of the entries to execute, in plan order.
+     * @param pooled Keep the nodes open for later transitions.
+     * @param preemptible Stop issuing writes once the preempt check fires.
+     * @return Per plan entry, a WriteResult.
+     */
+    std::vector<uint8_t> execute_batch(
+        const std::vector<NodeWrite> &plan, const std::vector<size_t> &pending, bool pooled, bool preemptible);
+};
+
+/**
+ * @brief Reads the SoC vendor recognized at install time.
+ *
+ * @param path Path to the soc_recognition file.
+ * @return Recognized vendor, or SocVendor::Unknown if the file is missing or invalid.
+ */
+SocVendor read_soc_vendor(const std::string &path);
@@ -0,0 +1,540 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sstream>
+
+#include "PlanBuilder.hpp"
+
+namespace {
+
+constexpr const char *MTK_GPU_POWER_LIMITS[] = {
+    "ignore_batt_oc", "ignore_batt_percent", "ignore_low_batt", "ignore_thermal_protect", "ignore_pbm_limited"
+};
+
+constexpr const char *QCOM_BUS_DCVS_COMPONENTS[] = {"DDR", "LLCC", "L3"};
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+void devfreq_max_perf(PlanBuilder &plan, const std::string &path) {
+    const std::string table = path + "/available_frequencies";
+    if (!plan.exists(table)) return;
+
+    const std::string max_freq = plan.max_freq(table);
+    plan.apply(max_freq, path + "/max_freq");
+    plan.apply(max_freq, path + "/min_freq");
+}
+
+void devfreq_mid_perf(PlanBuilder &plan, const std::string &path) {
+    const std::string table = path + "/available_frequencies";
+    if (!plan.exists(table)) return;
+
+    plan.apply(plan.max_freq(table), path + "/max_freq");
+    plan.apply(plan.mid_freq(table), path + "/min_freq");
+}
+
+void devfreq_unlock(PlanBuilder &plan, const std::string &path) {
+    const std::string table = path + "/available_frequencies";
+    if (!plan.exists(table)) return;
+
+    plan.write(plan.max_freq(table), path + "/max_freq");
+    plan.write(plan.min_freq(table), path + "/min_freq");
+}
+
+void devfreq_min_perf(PlanBuilder &plan, const std::string &path) {
+    const std::string table = path + "/available_frequencies";
+    if (!plan.exists(table)) return;
+
+    const std::string min_freq = plan.min_freq(table);
+    plan.apply(min_freq, path + "/min_freq");
+    plan.apply(min_freq, path + "/max_freq");
+}
+
+void devfreq_perf(PlanBuilder &plan, const std::string &path) {
+    if (plan.options().lite_mode) {
+        devfreq_mid_perf(plan, path);
+    } else {
+        devfreq_max_perf(plan, path);
+    }
+}
+
+void qcom_cpudcvs_perf(PlanBuilder &plan, const std::string &path) {
+    const std::string table = path + "/available_frequencies";
+    if (!plan.exists(table)) return;
+
+    const std::string max_freq = plan.max_freq(table);
+    plan.apply(max_freq, path + "/hw_max_freq");
+    plan.apply(plan.options().lite_mode ? plan.mid_freq(table) : max_freq, path + "/hw_min_freq");
+}
+
+void qcom_cpudcvs_unlock(PlanBuilder &plan, const std::string &path) {
+    const std::string table = path + "/available_frequencies";
+    if (!plan.exists(table)) return;
+
+    plan.write(plan.max_freq(table), path + "/hw_max_freq");
+    plan.write(plan.min_freq(table), path + "/hw_min_freq");
+}
+
+void snapdragon_force_kgsl_pwrlevel(PlanBuilder &plan, bool performance) {
+    const std::string kgsl = "/sys/class/kgsl/kgsl-3d0";
+    plan.raw(performance ? "0" : plan.read(kgsl + "/num_pwrlevels"), kgsl + "/min_pwrlevel");
+    plan.raw("0", kgsl + "/max_pwrlevel");
+}
+
+void mtk_ppm_policy(PlanBuilder &plan, bool enable) {
+    if (!plan.is_dir("/proc/ppm")) return;
+
+    std::istringstream rows(plan.read("/proc/ppm/policy_status"));
+    std::string row;
+
+    while (std::getline(rows, row)) {
+        if (row.size() < 2) continue;
+        if (row.find("PWR_THRO") == std::string::npos && row.find("THERMAL") == std::string::npos) continue;
+        plan.apply(std::string(1, row[1]) + (enable ? " 1" : " 0"), "/proc/ppm/policy_status");
+    }
+}
+
+std::string find_mali(PlanBuilder &plan) {
+    return plan.find_dir("/sys/devices/platform", "*.mali");
+}
+
+void mali_default_power_policy(PlanBuilder &plan, const std::string &mali) {
+    if (mali.empty()) return;
+
+    const std::string node = mali + "/power_policy";
+    const bool has_adaptive = plan.read(node).find("adaptive") != std::string::npos;
+    plan.apply(has_adaptive ? "adaptive" : "coarse_demand", node);
+}
+
+void mali_power_policy(PlanBuilder &plan, const std::string &mali, const char *policy) {
+    if (mali.empty()) return;
+    plan.apply(policy, mali + "/power_policy");
+}
+
+std::string exynos_gpu_freq_table(PlanBuilder &plan) {
+    if (plan.exists("/sys/kernel/gpu/gpu_available_frequencies")) return "/sys/kernel/gpu/gpu_available_frequencies";
+    if (plan.exists("/sys/kernel/gpu/gpu_freq_table")) return "/sys/kernel/gpu/gpu_freq_table";
+    return "";
+}
+
+std::string unisoc_gpu_devfreq(PlanBuilder &plan) {
+    auto matches = plan.list("/sys/class/devfreq", "*.gpu", true);
+    return matches.empty() ? "" : matches.front();
+}
+
+std::vector<std::string> qcom_latency_devfreqs(PlanBuilder &plan) {
+    std::vector<std::string> paths;
+    for (const char *pattern : {"*memlat*", "*latfloor*", "*ddr-lat*"}) {
+        for (auto &path : plan.list("/sys/class/devfreq", pattern)) {
+            paths.push_back(std::move(path));
+        }
+    }
+    return paths;
+}
+
+// =============================================================================
+// Device-specific performance profile
+// =============================================================================
+
+void mediatek_performance(PlanBuilder &plan) {
+    const bool lite_mode = plan.options().lite_mode;
+
+    // PPM policies
+    mtk_ppm_policy(plan, false);
+
+    // Force off FPSGO
+    plan.apply("0", "/sys/kernel/fpsgo/common/force_onoff");
+
+    // MTK Power and CCI mode
+    plan.apply("1", "/proc/cpufreq/cpufreq_cci_mode");
+    plan.apply("3", "/proc/cpufreq/cpufreq_power_mode");
+
+    // DDR Boost mode
+    plan.apply("1", "/sys/devices/platform/boot_dramboost/dramboost/dramboost");
+
+    // EAS/HMP Switch
+    plan.apply("0", "/sys/devices/system/cpu/eas/enable");
+
+    // Disable GED KPI
+    plan.apply("0", "/sys/module/sspm_v3/holders/ged/parameters/is_GED_KPI_enabled");
+
+    // GPU Frequency
+    plan.apply("0", "/proc/gpufreq/gpufreq_opp_freq");
+    plan.apply("-1", "/proc/gpufreqv2/fix_target_opp_index");
+
+    if (!lite_mode) {
+        if (plan.is_dir("/proc/gpufreqv2")) {
+            plan.apply("0", "/proc/gpufreqv2/fix_target_opp_index");
+        } else {
+            plan.apply(plan.opp_freq("/proc/gpufreq/gpufreq_opp_dump", true), "/proc/gpufreq/gpufreq_opp_freq");
+        }
+    }
+
+    // Disable GPU Power limiter
+    for (const char *setting : MTK_GPU_POWER_LIMITS) {
+        plan.apply(std::string(setting) + " 1", "/proc/gpufreq/gpufreq_power_limited");
+    }
+
+    // GPU Power Policy
+    mali_power_policy(plan, find_mali(plan), "always_on");
+
+    // Disable battery current limiter
+    plan.apply("stop 1", "/proc/mtk_batoc_throttling/battery_oc_protect_stop");
+
+    // DRAM Frequency
+    plan.apply("0", "/sys/kernel/helio-dvfsrc/dvfsrc_force_vcore_dvfs_opp");
+
+    for (const auto &path : plan.list("/sys/devices/platform", "*.dvfsrc")) {
+        plan.apply("0", path + "/helio-dvfsrc/dvfsrc_req_ddr_opp");
+    }
+
+    devfreq_perf(plan, "/sys/class/devfreq/mtk-dvfsrc-devfreq");
+
+    // Eara Thermal
+    plan.apply("0", "/sys/kernel/eara_thermal/enable");
+}
+
+void snapdragon_performance(PlanBuilder &plan) {
+    const bool lite_mode = plan.options().lite_mode;
+
+    // Qualcomm CPU Bus and DRAM frequencies
+    if (!plan.options().disable_ddr_tweak) {
+        for (const auto &path : qcom_latency_devfreqs(plan)) {
+            devfreq_perf(plan, path);
+        }
+
+        for (const char *component : QCOM_BUS_DCVS_COMPONENTS) {
+            qcom_cpudcvs_perf(plan, std::string("/sys/devices/system/cpu/bus_dcvs/") + component);
+        }
+    }
+
+    // GPU tweak
+    if (!lite_mode) {
+        devfreq_max_perf(plan, "/sys/class/kgsl/kgsl-3d0/devfreq");
+    } else {
+        devfreq_unlock(plan, "/sys/class/kgsl/kgsl-3d0/devfreq");
+    }
+    snapdragon_force_kgsl_pwrlevel(plan, !lite_mode);
+
+    // Disable GPU Bus split
+    plan.apply("0", "/sys/class/kgsl/kgsl-3d0/bus_split");
+
+    // Force GPU clock on
+    plan.apply("1", "/sys/class/kgsl/kgsl-3d0/force_clk_on");
+}
+
+void tegra_performance(PlanBuilder &plan) {
+    const std::string gpu_path = "/sys/kernel/tegra_gpu";
+    if (!plan.is_dir(gpu_path)) return;
+
+    const std::string table = gpu_path + "/available_frequencies";
+    const std::string max_freq = plan.max_freq(table);
+    plan.apply(max_freq, gpu_path + "/gpu_cap_rate");
+    plan.apply(plan.options().lite_mode ? plan.min_freq(table) : max_freq, gpu_path + "/gpu_floor_rate");
+}
+
+void exynos_performance(PlanBuilder &plan) {
+    // GPU Frequency
+    const std::string table = exynos_gpu_freq_table(plan);
+    if (!table.empty()) {
+        const std::string max_freq = plan.max_freq(table);
+        plan.apply(max_freq, "/sys/kernel/gpu/gpu_max_clock");
+        plan.apply(plan.options().lite_mode ? plan.min_freq(table) : max_freq, "/sys/kernel/gpu/gpu_min_clock");
+    }
+
+    mali_power_policy(plan, find_mali(plan), "always_on");
+
+    // DRAM and Buses Frequency
+    if (!plan.options().disable_ddr_tweak) {
+        for (const auto &path : plan.list("/sys/class/devfreq", "*devfreq_mif*")) {
+            devfreq_perf(plan, path);
+        }
+    }
+}
+
+void unisoc_performance(PlanBuilder &plan) {
+    // GPU Frequency
+    const std::string gpu_path = unisoc_gpu_devfreq(plan);
+    if (gpu_path.empty()) return;
+
+    if (!plan.options().lite_mode) {
+        devfreq_max_perf(plan, gpu_path);
+    } else {
+        devfreq_unlock(plan, gpu_path);
+    }
+}
+
+void tensor_performance(PlanBuilder &plan) {
+    // GPU Frequency
+    const std::string gpu_path = find_mali(plan);
+    if (!gpu_path.empty()) {
+        const std::string table = gpu_path + "/available_frequencies";
+        const std::string max_freq = plan.max_freq(table);
+        plan.apply(max_freq, gpu_path + "/scaling_max_freq");
+        plan.apply(plan.options().lite_mode ? plan.min_freq(table) : max_freq, gpu_path + "/scaling_min_freq");
+    }
+
+    // GPU Power Policy
+    mali_power_policy(plan, gpu_path, "always_on");
+
+    // DRAM frequency
+    if (!plan.options().disable_ddr_tweak) {
+        for (const auto &path : plan.list("/sys/class/devfreq", "*devfreq_mif*")) {
+            devfreq_perf(plan, path);
+        }
+    }
+}
+
+// =============================================================================
+// Device-specific normal profile
+// =============================================================================
+
+void mediatek_normal(PlanBuilder &plan) {
+    // PPM policies
+    mtk_ppm_policy(plan, true);
+
+    // Free FPSGO
+    plan.apply("2", "/sys/kernel/fpsgo/common/force_onoff");
+
+    // MTK Power and CCI mode
+    plan.apply("0", "/proc/cpufreq/cpufreq_cci_mode");
+    plan.apply("0", "/proc/cpufreq/cpufreq_power_mode");
+
+    // DDR Boost mode
+    plan.apply("0", "/sys/devices/platform/boot_dramboost/dramboost/dramboost");
+
+    // EAS/HMP Switch
+    plan.apply("2", "/sys/devices/system/cpu/eas/enable");
+
+    // Enable GED KPI
+    plan.apply("1", "/sys/module/sspm_v3/holders/ged/parameters/is_GED_KPI_enabled");
+
+    // GPU Frequency
+    plan.write("0", "/proc/gpufreq/gpufreq_opp_freq");
+    plan.write("-1", "/proc/gpufreqv2/fix_target_opp_index");
+
+    // Reset min freq via GED, once the fixed OPP is released
+    plan.barrier();
+    const std::string min_oppfreq = plan.is_dir("/proc/gpufreqv2")
+        ? plan.opp_min_index("/proc/gpufreqv2/gpu_working_opp_table")
+        : plan.opp_min_index("/proc/gpufreq/gpufreq_opp_dump");
+    plan.apply(min_oppfreq, "/sys/kernel/ged/hal/custom_boost_gpu_freq");
+
+    // GPU Power limiter
+    for (const char *setting : MTK_GPU_POWER_LIMITS) {
+        plan.apply(std::string(setting) + " 0", "/proc/gpufreq/gpufreq_power_limited");
+    }
+
+    // GPU Power Policy
+    mali_default_power_policy(plan, find_mali(plan));
+
+    // Enable battery current limiter
+    plan.apply("stop 0", "/proc/mtk_batoc_throttling/battery_oc_protect_stop");
+
+    // DRAM Frequency
+    for (const auto &path : plan.list("/sys/devices/platform", "*.dvfsrc")) {
+        plan.apply("-1", path + "/helio-dvfsrc/dvfsrc_req_ddr_opp");
+    }
+
+    plan.write("-1", "/sys/kernel/helio-dvfsrc/dvfsrc_force_vcore_dvfs_opp");
+    devfreq_unlock(plan, "/sys/class/devfreq/mtk-dvfsrc-devfreq");
+
+    // Eara Thermal
+    plan.apply("1", "/sys/kernel/eara_thermal/enable");
+}
+
+void snapdragon_normal(PlanBuilder &plan) {
+    // Qualcomm CPU Bus and DRAM frequencies
+    if (!plan.options().disable_ddr_tweak) {
+        for (const auto &path : qcom_latency_devfreqs(plan)) {
+            devfreq_unlock(plan, path);
+        }
+
+        for (const char *component : QCOM_BUS_DCVS_COMPONENTS) {
+            qcom_cpudcvs_unlock(plan, std::string("/sys/devices/system/cpu/bus_dcvs/") + component);
+        }
+    }
+
+    // Revert GPU tweak
+    devfreq_unlock(plan, "/sys/class/kgsl/kgsl-3d0/devfreq");
+    snapdragon_force_kgsl_pwrlevel(plan, false);
+
+    // Enable back GPU Bus split
+    plan.apply("1", "/sys/class/kgsl/kgsl-3d0/bus_split");
+
+    // Free GPU clock on/off
+    plan.apply("0", "/sys/class/kgsl/kgsl-3d0/force_clk_on");
+}
+
+void tegra_normal(PlanBuilder &plan) {
+    const std::string gpu_path = "/sys/kernel/tegra_gpu";
+    if (!plan.is_dir(gpu_path)) return;
+
+    const std::string table = gpu_path + "/available_frequencies";
+    plan.write(plan.max_freq(table), gpu_path + "/gpu_cap_rate");
+    plan.write(plan.min_freq(table), gpu_path + "/gpu_floor_rate");
+}
+
+void exynos_normal(PlanBuilder &plan) {
+    // GPU Frequency
+    const std::string table = exynos_gpu_freq_table(plan);
+    if (!table.empty()) {
+        plan.write(plan.max_freq(table), "/sys/kernel/gpu/gpu_max_clock");
+        plan.write(plan.min_freq(table), "/sys/kernel/gpu/gpu_min_clock");
+    }
+
+    mali_default_power_policy(plan, find_mali(plan));
+
+    // DRAM frequency
+    if (!plan.options().disable_ddr_tweak) {
+        for (const auto &path : plan.list("/sys/class/devfreq", "*devfreq_mif*")) {
+            devfreq_unlock(plan, path);
+        }
+    }
+}
+
+void unisoc_normal(PlanBuilder &plan) {
+    // GPU Frequency
+    const std::string gpu_path = unisoc_gpu_devfreq(plan);
+    if (!gpu_path.empty()) devfreq_unlock(plan, gpu_path);
+}
+
+void tensor_normal(PlanBuilder &plan) {
+    // GPU Frequency
+    const std::string gpu_path = find_mali(plan);
+    if (!gpu_path.empty()) {
+        const std::string table = gpu_path + "/available_frequencies";
+        plan.write(plan.max_freq(table), gpu_path + "/scaling_max_freq");
+        plan.write(plan.min_freq(table), gpu_path + "/scaling_min_freq");
+    }
+
+    // GPU Power Policy
+    mali_default_power_policy(plan, gpu_path);
+
+    // DRAM frequency
+    if (!plan.options().disable_ddr_tweak) {
+        for (const auto &path : plan.list("/sys/class/devfreq", "*devfreq_mif*")) {
+            devfreq_unlock(plan, path);
+        }
+    }
+}
+
+// =============================================================================
+// Device-specific powersave profile
+// =============================================================================
+
+void mediatek_powersave(PlanBuilder &plan) {
+    // Set MTK CPU Power mode to low power
+    plan.apply("1", "/proc/cpufreq/cpufreq_power_mode");
+
+    // GPU Frequency
+    if (plan.is_dir("/proc/gpufreqv2")) {
+        plan.apply(plan.opp_min_index("/proc/gpufreqv2/gpu_working_opp_table"), "/proc/gpufreqv2/fix_target_opp_index");
+    } else {
+        plan.apply(plan.opp_freq("/proc/gpufreq/gpufreq_opp_dump", false), "/proc/gpufreq/gpufreq_opp_freq");
+    }
+
+    // GPU Power Policy
+    mali_power_policy(plan, find_mali(plan), "coarse_demand");
+}
+
+void snapdragon_powersave(PlanBuilder &plan) {
+    // GPU Frequency
+    // There's some report that this causes no video issue after the phone went sleep and awaken
+    if (!plan.options().qcom_no_gpu_powersave) {
+        devfreq_min_perf(plan, "/sys/class/kgsl/kgsl-3d0/devfreq");
+    }
+}
+
+void tegra_powersave(PlanBuilder &plan) {
+    const std::string gpu_path = "/sys/kernel/tegra_gpu";
+    if (!plan.is_dir(gpu_path)) return;
+
+    const std::string freq = plan.min_freq(gpu_path + "/available_frequencies");
+    plan.apply(freq, gpu_path + "/gpu_floor_rate");
+    plan.apply(freq, gpu_path + "/gpu_cap_rate");
+}
+
+void exynos_powersave(PlanBuilder &plan) {
+    // GPU Frequency
+    const std::string table = exynos_gpu_freq_table(plan);
+    if (!table.empty()) {
+        const std::string freq = plan.min_freq(table);
+        plan.apply(freq, "/sys/kernel/gpu/gpu_min_clock");
+        plan.apply(freq, "/sys/kernel/gpu/gpu_max_clock");
+    }
+
+    // GPU Power Policy
+    mali_power_policy(plan, find_mali(plan), "coarse_demand");
+}
+
+void unisoc_powersave(PlanBuilder &plan) {
+    // GPU Frequency
+    const std::string gpu_path = unisoc_gpu_devfreq(plan);
+    if (!gpu_path.empty()) devfreq_min_perf(plan, gpu_path);
+}
+
+void tensor_powersave(PlanBuilder &plan) {
+    // GPU Frequency
+    const std::string gpu_path = find_mali(plan);
+    if (gpu_path.empty()) return;
+
+    const std::string freq = plan.min_freq(gpu_path + "/available_frequencies");
+    plan.apply(freq, gpu_path + "/scaling_min_freq");
+    plan.apply(freq, gpu_path + "/scaling_max_freq");
+
+    // GPU Power Policy
+    mali_power_policy(plan, gpu_path, "coarse_demand");
+}
+
+} // namespace
+
+void soc_performance(PlanBuilder &plan) {
+    switch (plan.options().soc) {
+        case SocVendor::MediaTek: mediatek_performance(plan); break;
+        case SocVendor::Snapdragon: snapdragon_performance(plan); break;
+        case SocVendor::Exynos: exynos_performance(plan); break;
+        case SocVendor::Unisoc: unisoc_performance(plan); break;
+        case SocVendor::Tensor: tensor_performance(plan); break;
+        case SocVendor::Tegra: tegra_performance(plan); break;
+        default: break;
+    }
+}
+
+void soc_balance(PlanBuilder &plan) {
+    switch (plan.options().soc) {
+        case SocVendor::MediaTek: mediatek_normal(plan); break;
+        case SocVendor::Snapdragon: snapdragon_normal(plan); break;
+        case SocVendor::Exynos: exynos_normal(plan); break;
+        case SocVendor::Unisoc: unisoc_normal(plan); break;
+        case SocVendor::Tensor: tensor_normal(plan); break;
+        case SocVendor::Tegra: tegra_normal(plan); break;
+        default: break;
+    }
+}
+
+void soc_powersave(PlanBuilder &plan) {
+    switch (plan.options().soc) {
+        case SocVendor::MediaTek: mediatek_powersave(plan); break;
+        case SocVendor::Snapdragon: snapdragon_powersave(plan); break;
+        case SocVendor::Exynos: exynos_powersave(plan); break;
+        case SocVendor::Unisoc: unisoc_powersave(plan); break;
+        case SocVendor::Tensor: tensor_powersave(plan); break;
+        case SocVendor::Tegra: tegra_powersave(plan); break;
+        default: break;
+    }
+}
@@ -0,0 +1,352 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/filereadstream.h>
+
+#include <Encore.hpp>
+#include <EncoreLog.hpp>
+
+#include "ProfileEngine.hpp"
+#include "TweakBlob.hpp"
+
+namespace {
+
+constexpr char TWEAK_BLOB_MAGIC[4] = {'E', 'N', 'C', 'T'};
+
+const std::unordered_map<std::string_view, EncoreProfileMode> PROFILE_NAMES = {
+    {"perfcommon", PERFCOMMON},
+    {"performance", PERFORMANCE_PROFILE},
+    {"balance", BALANCE_PROFILE},
+    {"powersave", POWERSAVE_PROFILE},
+};
+
+const std::unordered_map<std::string_view, SocVendor> SOC_NAMES = {
+    {"mediatek", SocVendor::MediaTek}, {"snapdragon", SocVendor::Snapdragon}, {"exynos", SocVendor::Exynos},
+    {"unisoc", SocVendor::Unisoc},     {"tensor", SocVendor::Tensor},         {"tegra", SocVendor::Tegra},
+    {"kirin", SocVendor::Kirin},
+};
+
+const std::unordered_map<std::string_view, uint8_t> FLAG_NAMES = {
+    {"LITE_MODE", TWEAK_FLAG_LITE_MODE},
+    {"DISABLE_DDR_TWEAK", TWEAK_FLAG_DISABLE_DDR_TWEAK},
+    {"NO_PERFORMANCE_CPUGOV", TWEAK_FLAG_NO_PERFORMANCE_CPUGOV},
+    {"QCOM_NO_GPU_POWERSAVE", TWEAK_FLAG_QCOM_NO_GPU_POWERSAVE},
+};
+
+const std::unordered_map<std::string_view, WriteMode> MODE_NAMES = {
+    {"apply", WriteMode::Apply},
+    {"write", WriteMode::Write},
+    {"raw", WriteMode::Raw},
+};
+
+/**
+ * @brief NUL-separated string table, identical strings are stored once.
+ */
+class StringTable {
+public:
+    uint32_t add(const std::string &str) {
+        auto it = offsets_.find(str);
+        if (it != offsets_.end()) return it->second;
+
+        const auto offset = static_cast<uint32_t>(data_.size());
+        data_.insert(data_.end(), str.begin(), str.end());
+        data_.push_back('\0');
+        offsets_.emplace(str, offset);
+        return offset;
+    }
+
+    const std::vector<char> &data() const {
+        return data_;
+    }
+
+private:
+    std::vector<char> data_;
+    std::unordered_map<std::string, uint32_t> offsets_;
+};
+
+/**
+ * @brief Splits "max(table)", "mid(table)" and "min(table)" value expressions.
+ */
+TweakValue parse_value_expression(const std::string &value, std::string &operand) {
+    static constexpr std::pair<std::string_view, TweakValue> functions[] = {
+        {"max(", TweakValue::TableMax},
+        {"mid(", TweakValue::TableMid},
+        {"min(", TweakValue::TableMin},
+    };
+
+    for (const auto &[prefix, kind] : functions) {
+        if (value.size() > prefix.size() + 1 && value.starts_with(prefix) && value.back() == ')') {
+            operand = value.substr(prefix.size(), value.size() - prefix.size() - 1);
+            return kind;
+        }
+    }
+
+    operand = value;
+    return TweakValue::Literal;
+}
+
+bool parse_tweak(const rapidjson::Value &obj, size_t index, StringTable &strings, TweakEntry &entry) {
+    if (!obj.IsObject()) {
+        LOGE_TAG("TweakBlob", "Tweak #{} is not an object", index);
+        return false;
+    }
+
+    entry = TweakEntry{0, 0, 0, 0, static_cast<uint8_t>(WriteMode::Apply), 0, 0, 0, 0};
+
+    if (!obj.HasMember("path") || !obj["path"].IsString() || obj["path"].GetString()[0] != '/') {
+        LOGE_TAG("TweakBlob", "Tweak #{}: path must be an absolute path", index);
+        return false;
+    }
+    entry.path = strings.add(obj["path"].GetString());
+
+    std::string value;
+    if (obj.HasMember("value") && obj["value"].IsString()) {
+        value = obj["value"].GetString();
+    } else if (obj.HasMember("value") && obj["value"].IsInt64()) {
+        value = std::to_string(obj["value"].GetInt64());
+    } else {
+        LOGE_TAG("TweakBlob", "Tweak #{}: value must be a string or an integer", index);
+        return false;
+    }
+
+    std::string operand;
+    entry.value_kind = static_cast<uint8_t>(parse_value_expression(value, operand));
+    entry.value = strings.add(operand);
+
+    if (!obj.HasMember("profiles") || !obj["profiles"].IsArray() || obj["profiles"].Empty()) {
+        LOGE_TAG("TweakBlob", "Tweak #{}: profiles must be a non-empty array", index);
+        return false;
+    }
+
+    for (const auto &profile : obj["profiles"].GetArray()) {
+        auto it = profile.IsString() ? PROFILE_NAMES.find(profile.GetString()) : PROFILE_NAMES.end();
+        if (it == PROFILE_NAMES.end()) {
+            LOGE_TAG("TweakBlob", "Tweak #{}: unknown profile", index);
+            return false;
+        }
+        entry.profiles |= static_cast<uint8_t>(1 << it->second);
+    }
+
+    if (obj.HasMember("soc")) {
+        if (!obj["soc"].IsArray()) {
+            LOGE_TAG("TweakBlob", "Tweak #{}: soc must be an array", index);
+            return false;
+        }
+
+        for (const auto &soc : obj["soc"].GetArray()) {
+            auto it = soc.IsString() ? SOC_NAMES.find(soc.GetString()) : SOC_NAMES.end();
+            if (it == SOC_NAMES.end()) {
+                LOGE_TAG("TweakBlob", "Tweak #{}: unknown soc", index);
+                return false;
+            }
+            entry.soc_mask |= static_cast<uint16_t>(1 << static_cast<int>(it->second));
+        }
+    }
+
+    if (obj.HasMember("when")) {
+        if (!obj["when"].IsArray()) {
+            LOGE_TAG("TweakBlob", "Tweak #{}: when must be an array", index);
+            return false;
+        }
+
+        for (const auto &cond : obj["when"].GetArray()) {
+            std::string_view name = cond.IsString() ? cond.GetString() : "";
+            const bool negated = name.starts_with('!');
+            if (negated) name.remove_prefix(1);
+
+            auto it = FLAG_NAMES.find(name);
+            if (it == FLAG_NAMES.end()) {
+                LOGE_TAG("TweakBlob", "Tweak #{}: unknown condition {}", index, name);
+                return false;
+            }
+            (negated ? entry.forbid : entry.require) |= it->second;
+        }
+    }
+
+    if (obj.HasMember("mode")) {
+        auto it = obj["mode"].IsString() ? MODE_NAMES.find(obj["mode"].GetString()) : MODE_NAMES.end();
+        if (it == MODE_NAMES.end()) {
+            LOGE_TAG("TweakBlob", "Tweak #{}: mode must be apply, write or raw", index);
+            return false;
+        }
+        entry.mode = static_cast<uint8_t>(it->second);
+    }
+
+    return true;
+}
+
+} // namespace
+
+bool compile_tweaks(const std::string &json_path, const std::string &blob_path) {
+    FILE *fp = fopen(json_path.c_str(), "rb");
+    if (!fp) {
+        LOGE_TAG("TweakBlob", "{}: {}", json_path, strerror(errno));
+        return false;
+    }
+
+    char readBuffer[65536];
+    rapidjson::FileReadStream is(fp, readBuffer, sizeof(readBuffer));
+
+    rapidjson::Document doc;
+    doc.ParseStream(is);
+    fclose(fp);
+
+    if (doc.HasParseError()) {
+        LOGE_TAG("TweakBlob", "{}: parse error: {} (Offset: {})",
+                 json_path, rapidjson::GetParseError_En(doc.GetParseError()), doc.GetErrorOffset());
+        return false;
+    }
+
+    if (!doc.IsObject() || !doc.HasMember("tweaks") || !doc["tweaks"].IsArray()) {
+        LOGE_TAG("TweakBlob", "{}: tweaks array is missing", json_path);
+        return false;
+    }
+
+    const auto &tweaks = doc["tweaks"];
+    if (tweaks.Size() > UINT16_MAX) {
+        LOGE_TAG("TweakBlob", "{}: too many tweaks", json_path);
+        return false;
+    }
+
+    StringTable strings;
+    std::vector<TweakEntry> entries;
+    entries.reserve(tweaks.Size());
+
+    for (rapidjson::SizeType i = 0; i < tweaks.Size(); i++) {
+        TweakEntry entry{};
+        if (!parse_tweak(tweaks[i], i, strings, entry)) return false;
+        entries.push_back(entry);
+    }
+
+    TweakBlobHeader header{};
+    memcpy(header.magic, TWEAK_BLOB_MAGIC, sizeof(header.magic));
+    header.version = TWEAK_BLOB_VERSION;
+    header.count = static_cast<uint16_t>(entries.size());
+    header.strings_size = static_cast<uint32_t>(strings.data().size());
+
+    // Write to a temporary file first so a running daemon never maps a partial blob
+    const std::string tmp_path = blob_path + ".tmp";
+    std::ofstream output_file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!output_file.is_open()) {
+        LOGE_TAG("TweakBlob", "Failed to create {}", tmp_path);
+        return false;
+    }
+
+    output_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    output_file.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(TweakEntry)));
+    output_file.write(strings.data().data(), static_cast<std::streamsize>(strings.data().size()));
+    output_file.close();
+
+    if (!output_file || rename(tmp_path.c_str(), blob_path.c_str()) != 0) {
+        LOGE_TAG("TweakBlob", "Failed to write {}: {}", blob_path, strerror(errno));
+        unlink(tmp_path.c_str());
+        return false;
+    }
+
+    LOGI_TAG("TweakBlob", "Compiled {} tweaks into {}", entries.size(), blob_path);
+    return true;
+}
+
+TweakBlob::~TweakBlob() {
+    if (map_) munmap(map_, length_);
+}
+
+std::unique_ptr<TweakBlob> TweakBlob::open(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOGD_TAG("TweakBlob", "{}: {}", path, strerror(errno));
+        return nullptr;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TweakBlobHeader)) {
+        LOGW_TAG("TweakBlob", "{}: truncated blob", path);
+        close(fd);
+        return nullptr;
+    }
+
+    const auto length = static_cast<size_t>(st.st_size);
+    void *map = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        LOGW_TAG("TweakBlob", "{}: mmap failed: {}", path, strerror(errno));
+        return nullptr;
+    }
+
+    std::unique_ptr<TweakBlob> blob(new TweakBlob());
+    blob->map_ = map;
+    blob->length_ = length;
+
+    const auto *header = static_cast<const TweakBlobHeader *>(map);
+    const size_t entries_size = static_cast<size_t>(header->count) * sizeof(TweakEntry);
+
+    if (memcmp(header->magic, TWEAK_BLOB_MAGIC, sizeof(header->magic)) != 0 || header->version != TWEAK_BLOB_VERSION ||
+        sizeof(TweakBlobHeader) + entries_size + header->strings_size != length) {
+        LOGW_TAG("TweakBlob", "{}: invalid or outdated blob", path);
+        return nullptr;
+    }
+
+    blob->entries_ = reinterpret_cast<const TweakEntry *>(static_cast<const char *>(map) + sizeof(TweakBlobHeader));
+    blob->count_ = header->count;
+    blob->strings_ = reinterpret_cast<const char *>(blob->entries_) + entries_size;
+
+    // Every string offset must point at a NUL-terminated string inside the table
+    const uint32_t strings_size = header->strings_size;
+    if (strings_size > 0 && blob->strings_[strings_size - 1] != '\0') {
+        LOGW_TAG("TweakBlob", "{}: unterminated string table", path);
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < blob->count_; i++) {
+        const TweakEntry &entry = blob->entries_[i];
+        if (entry.path >= strings_size || entry.value >= strings_size ||
+            entry.value_kind > static_cast<uint8_t>(TweakValue::TableMin) ||
+            entry.mode > static_cast<uint8_t>(WriteMode::Raw)) {
+            LOGW_TAG("TweakBlob", "{}: entry #{} is out of bounds", path, i);
+            return nullptr;
+        }
+    }
+
+    LOGI_TAG("TweakBlob", "Mapped {} declared tweaks from {}", blob->count_, path);
+    return blob;
+}
+
+size_t TweakBlob::size() const {
+    return count_;
+}
+
+const TweakEntry &TweakBlob::entry(size_t index) const {
+    return entries_[index];
+}
+
+const char *TweakBlob::string(uint32_t offset) const {
+    return strings_ + offset;
+}
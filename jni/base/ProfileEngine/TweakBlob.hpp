@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @brief How the value of a declared tweak is computed.
+ */
+enum class TweakValue : uint8_t {
+    Literal,  ///< Value string is written as is
+    TableMax, ///< Highest frequency of the table named by the value string
+    TableMid, ///< Middle frequency of the table named by the value string
+    TableMin  ///< Lowest frequency of the table named by the value string
+};
+
+/**
+ * @brief Conditions a declared tweak can require or forbid.
+ */
+enum TweakFlag : uint8_t {
+    TWEAK_FLAG_LITE_MODE = 1 << 0,
+    TWEAK_FLAG_DISABLE_DDR_TWEAK = 1 << 1,
+    TWEAK_FLAG_NO_PERFORMANCE_CPUGOV = 1 << 2,
+    TWEAK_FLAG_QCOM_NO_GPU_POWERSAVE = 1 << 3
+};
+
+/**
+ * @brief A declared tweak as stored in the compiled blob.
+ */
+struct TweakEntry {
+    uint32_t path;      /// String table offset of the node path pattern
+    uint32_t value;     /// String table offset of the literal value or table path
+    uint16_t soc_mask;  /// Bit per SocVendor the tweak applies to, 0 for any
+    uint8_t profiles;   /// Bit per EncoreProfileMode the tweak is part of
+    uint8_t mode;       /// WriteMode of the write
+    uint8_t value_kind; /// TweakValue
+    uint8_t require;    /// TweakFlag bits that must be set
+    uint8_t forbid;     /// TweakFlag bits that must be clear
+    uint8_t reserved;
+};
+
+static_assert(sizeof(TweakEntry) == 16, "TweakEntry is part of the blob format");
+
+/**
+ * @brief Header of the compiled blob, followed by the entries and the string table.
+ */
+struct TweakBlobHeader {
+    char magic[4];         /// "ENCT"
+    uint16_t version;      /// TWEAK_BLOB_VERSION
+    uint16_t count;        /// Number of entries
+    uint32_t strings_size; /// Size of the NUL-separated string table
+};
+
+static_assert(sizeof(TweakBlobHeader) == 12, "TweakBlobHeader is part of the blob format");
+
+constexpr uint16_t TWEAK_BLOB_VERSION = 1;
+
+/**
+ * @brief Compiles declarative tweak definitions into a blob.
+ *
+ * @param json_path Tweak definitions, see config/README.md for the format.
+ * @param blob_path Output path of the compiled blob.
+ * @return true on success, false if the definitions are invalid or the blob cannot be written.
+ */
+bool compile_tweaks(const std::string &json_path, const std::string &blob_path);
+
+/**
+ * @class TweakBlob
+ * @brief Read-only mapping of a compiled tweak blob.
+ */
+class TweakBlob {
+public:
+    ~TweakBlob();
+
+    TweakBlob(const TweakBlob &) = delete;
+    TweakBlob &operator=(const TweakBlob &) = delete;
+
+    /**
+     * @brief Maps and validates a compiled blob.
+     *
+     * @param path Path of the blob.
+     * @return Mapped blob, or nullptr if it is missing or malformed.
+     */
+    static std::unique_ptr<TweakBlob> open(const std::string &path);
+
+    size_t size() const;
+    const TweakEntry &entry(size_t index) const;
+
+    /**
+     * @brief Resolves a string table offset.
+     */
+    const char *string(uint32_t offset) const;
+
+private:
+    TweakBlob() = default;
+
+    void *map_ = nullptr;
+    size_t length_ = 0;
+    const TweakEntry *entries_ = nullptr;
+    size_t count_ = 0;
+    const char *strings_ = nullptr;
+};
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkerPool
+ * @brief Small fixed pool of threads running batches of independent tasks.
+ *
+ * The calling thread takes part in every batch, so a pool of N threads runs N + 1 tasks at once.
+ * Threads are parked on a condition variable between batches.
+ */
+class WorkerPool {
+public:
+    /**
+     * @param threads Number of helper threads to spawn.
+     */
+    explicit WorkerPool(size_t threads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    /**
+     * @brief Runs task(i) for every i in [0, count) and waits until all of them finished.
+     *
+     * @param count Number of tasks in the batch.
+     * @param task Task body, must be safe to call concurrently for different indices.
+     */
+    void run(size_t count, const std::function<void(size_t)> &task);
+
+private:
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+
+    const std::function<void(size_t)> *task_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_{0};
+    size_t active_ = 0;
+    uint64_t generation_ = 0;
+    bool stop_ = false;
+
+    void worker_loop();
+    void drain();
+};
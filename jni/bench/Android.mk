@@ -0,0 +1,17 @@
+LOCAL_PATH := $(call my-dir)
+ROOT_PATH := $(call my-dir)/..
+
+include $(CLEAR_VARS)
+LOCAL_MODULE := encore_bench
+
+LOCAL_SRC_FILES := $(wildcard $(LOCAL_PATH)/*.cpp)
+LOCAL_SRC_FILES := $(LOCAL_SRC_FILES:$(LOCAL_PATH)/%=%)
+
+LOCAL_STATIC_LIBRARIES := rapidjson spdlog ProfileEngine
+
+LOCAL_C_INCLUDES := $(ROOT_PATH)/include
+
+LOCAL_CPPFLAGS += -fexceptions -std=c++23 -O2
+LOCAL_CPPFLAGS += -Wpedantic -Wall -Wextra -Werror -Wformat -Wuninitialized
+
+include $(BUILD_EXECUTABLE)
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file Benchmark.cpp
+ * @brief Measures profile transition latency against a synthetic sysfs tree.
+ *
+ * Build with `ndk-build ENCORE_BENCH=1`, push encore_bench to the device and run it as root.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <sys/ptrace.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#include <EncoreLog.hpp>
+#include <ProfileEngine.hpp>
+
+#include "FakeSysfs.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Transition {
+    const char *name;
+    EncoreProfileMode from; /// Profile applied before the measured one
+    EncoreProfileMode to;   /// Measured profile
+    bool lite_mode;
+};
+
+constexpr Transition TRANSITIONS[] = {
+    {"perfcommon", PERFCOMMON, PERFCOMMON, false},
+    {"performance", BALANCE_PROFILE, PERFORMANCE_PROFILE, false},
+    {"performance_lite", BALANCE_PROFILE, PERFORMANCE_PROFILE, true},
+    {"balance", PERFORMANCE_PROFILE, BALANCE_PROFILE, false},
+    {"powersave", BALANCE_PROFILE, POWERSAVE_PROFILE, false},
+};
+
+struct BenchOptions {
+    std::string root;
+    std::vector<SocVendor> socs = {SocVendor::MediaTek, SocVendor::Snapdragon, SocVendor::Exynos};
+    size_t iterations = 200;
+    size_t lanes = 4;
+    bool cold = false;
+    bool keep_tree = false;
+    bool temp_root = false; /// Root was created by us and may be removed
+};
+
+const char *soc_name(SocVendor soc) {
+    switch (soc) {
+        case SocVendor::MediaTek: return "MediaTek";
+        case SocVendor::Snapdragon: return "Snapdragon";
+        case SocVendor::Exynos: return "Exynos";
+        default: return "Unknown";
+    }
+}
+
+ProfileOptions make_options(SocVendor soc, bool lite_mode) {
+    ProfileOptions options;
+    options.soc = soc;
+    options.lite_mode = lite_mode;
+    options.balance_cpugov = "schedutil";
+    options.powersave_cpugov = "powersave";
+    return options;
+}
+
+/**
+ * @brief Applies the outgoing profile of a transition, so the measured one starts from it.
+ */
+void prepare(ProfileEngine &engine, const Transition &transition, SocVendor soc, bool cold) {
+    if (transition.from != transition.to) {
+        engine.apply(transition.from, make_options(soc, false));
+    }
+    if (cold || transition.to == PERFCOMMON) {
+        engine.invalidate();
+    }
+}
+
+double percentile(std::vector<double> samples, double pct) {
+    if (samples.empty()) return 0.0;
+    std::sort(samples.begin(), samples.end());
+    size_t index = static_cast<size_t>(pct / 100.0 * static_cast<double>(samples.size() - 1) + 0.5);
+    return samples[std::min(index, samples.size() - 1)];
+}
+
+std::vector<double> measure_latency(const std::string &root, const Transition &transition, SocVendor soc, const BenchOptions &opts) {
+    ProfileEngine engine(root);
+    engine.set_parallelism(opts.lanes);
+    engine.discover(make_options(soc, false));
+
+    const ProfileOptions options = make_options(soc, transition.lite_mode);
+    std::vector<double> samples;
+    samples.reserve(opts.iterations);
+
+    for (size_t i = 0; i < opts.iterations; i++) {
+        prepare(engine, transition, soc, opts.cold);
+
+        auto start = std::chrono::steady_clock::now();
+        engine.apply(transition.to, options);
+        auto end = std::chrono::steady_clock::now();
+
+        samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    return samples;
+}
+
+/**
+ * @brief Counts the syscalls issued by a single transition by tracing a forked child.
+ *
+ * The child applies the transition sequentially, so worker thread wakeups are not included.
+ *
+ * @return Number of syscalls, or -1 if tracing failed.
+ */
+long count_syscalls(const std::string &root, const Transition &transition, SocVendor soc, bool cold) {
+    pid_t pid = fork();
+    if (pid < 0) return -1;
+
+    if (pid == 0) {
+        ProfileEngine engine(root);
+        engine.set_parallelism(1);
+        engine.discover(make_options(soc, false));
+        prepare(engine, transition, soc, cold);
+
+        const ProfileOptions options = make_options(soc, transition.lite_mode);
+        if (ptrace(PTRACE_TRACEME, 0, nullptr, nullptr) != 0) _exit(EXIT_FAILURE);
+        raise(SIGSTOP);
+
+        engine.apply(transition.to, options);
+        _exit(EXIT_SUCCESS);
+    }
+
+    int status = 0;
+    if (waitpid(pid, &status, 0) != pid || !WIFSTOPPED(status)) return -1;
+    ptrace(PTRACE_SETOPTIONS, pid, nullptr, reinterpret_cast<void *>(PTRACE_O_TRACESYSGOOD | PTRACE_O_EXITKILL));
+
+    long syscalls = 0;
+    bool in_syscall = false;
+
+    while (ptrace(PTRACE_SYSCALL, pid, nullptr, nullptr) == 0) {
+        if (waitpid(pid, &status, 0) != pid) return -1;
+        if (WIFEXITED(status) || WIFSIGNALED(status)) break;
+
+        if (WIFSTOPPED(status) && WSTOPSIG(status) == (SIGTRAP | 0x80)) {
+            in_syscall = !in_syscall;
+            if (in_syscall) syscalls++;
+        }
+    }
+
+    // Don't count the final exit_group()
+    return std::max(syscalls - 1, 0L);
+}
+
+void print_bench_help(const char *program_name) {
+    std::cout << "Usage: " << program_name << " [OPTIONS]\n\n";
+    std::cout << "Measure profile transition latency against a synthetic sysfs tree.\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --root DIR           Directory for the synthetic tree (default: temporary directory)\n";
+    std::cout << "  --soc SOC            mediatek, snapdragon, exynos or all (default: all)\n";
+    std::cout << "  --iterations N       Samples per transition (default: 200)\n";
+    std::cout << "  --lanes N            Concurrent node writers, 1 for sequential (default: 4)\n";
+    std::cout << "  --cold               Forget written values and open nodes before every sample\n";
+    std::cout << "  --keep               Keep the synthetic tree after the run\n";
+    std::cout << "  -h, --help           Show this help message\n";
+}
+
+bool parse_args(int argc, char *argv[], BenchOptions &opts) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if (arg == "--root" && has_value) {
+            opts.root = argv[++i];
+        } else if (arg == "--soc" && has_value) {
+            const std::string soc = argv[++i];
+            if (soc == "mediatek") {
+                opts.socs = {SocVendor::MediaTek};
+            } else if (soc == "snapdragon") {
+                opts.socs = {SocVendor::Snapdragon};
+            } else if (soc == "exynos") {
+                opts.socs = {SocVendor::Exynos};
+            } else if (soc != "all") {
+                std::cerr << "Unknown SoC: " << soc << '\n';
+                return false;
+            }
+        } else if (arg == "--iterations" && has_value) {
+            opts.iterations = std::max(1UL, std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--lanes" && has_value) {
+            opts.lanes = std::max(1UL, std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--cold") {
+            opts.cold = true;
+        } else if (arg == "--keep") {
+            opts.keep_tree = true;
+        } else {
+            print_bench_help(argv[0]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    BenchOptions opts;
+    if (!parse_args(argc, argv, opts)) return EXIT_FAILURE;
+
+    if (opts.root.empty()) {
+        char tmpl[] = "/data/local/tmp/encore_bench.XXXXXX";
+        char fallback[] = "/tmp/encore_bench.XXXXXX";
+        const char *dir = mkdtemp(tmpl);
+        if (!dir) dir = mkdtemp(fallback);
+        if (!dir) {
+            std::cerr << "Unable to create temporary directory: " << strerror(errno) << '\n';
+            return EXIT_FAILURE;
+        }
+        opts.root = dir;
+        opts.temp_root = true;
+    }
+
+    // Keep logging out of the measurements
+    EncoreLog::init(opts.root + "/bench.log");
+    EncoreLog::get()->set_level(spdlog::level::warn);
+
+    std::cout << "Root: " << opts.root << ", iterations: " << opts.iterations << ", lanes: " << opts.lanes
+              << (opts.cold ? ", cold" : ", warm") << "\n\n";
+    std::cout << std::left << std::setw(12) << "SoC" << std::setw(18) << "Transition" << std::right << std::setw(12)
+              << "p50 (us)" << std::setw(12) << "p99 (us)" << std::setw(10) << "writes" << std::setw(10) << "syscalls"
+              << '\n';
+
+    for (SocVendor soc : opts.socs) {
+        const std::string root = opts.root + "/" + soc_name(soc);
+        if (!populate_fake_sysfs(root, soc)) {
+            std::cerr << "Unable to populate synthetic tree at " << root << '\n';
+            return EXIT_FAILURE;
+        }
+
+        for (const auto &transition : TRANSITIONS) {
+            const auto samples = measure_latency(root, transition, soc, opts);
+
+            ProfileEngine probe(root);
+            prepare(probe, transition, soc, opts.cold);
+            const size_t writes = probe.diff_plan(probe.build_plan(transition.to, make_options(soc, transition.lite_mode))).size();
+
+            std::cout << std::left << std::setw(12) << soc_name(soc) << std::setw(18) << transition.name << std::right
+                      << std::fixed << std::setprecision(1) << std::setw(12) << percentile(samples, 50.0)
+                      << std::setw(12) << percentile(samples, 99.0) << std::setw(10) << writes << std::setw(10)
+                      << count_syscalls(root, transition, soc, opts.cold) << '\n';
+        }
+    }
+
+    if (!opts.keep_tree) {
+        std::error_code ec;
+        for (SocVendor soc : opts.socs) {
+            fs::remove_all(opts.root + "/" + soc_name(soc), ec);
+        }
+        if (opts.temp_root) fs::remove_all(opts.root, ec);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "FakeSysfs.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Cluster {
+    const char *policy;
+    std::vector<unsigned long> freqs;
+};
+
+class TreeWriter {
+public:
+    explicit TreeWriter(const std::string &root)
+        : root_(root) {
+    }
+
+    void node(const std::string &path, const std::string &value) {
+        const fs::path full = root_ + path;
+        std::error_code ec;
+        fs::create_directories(full.parent_path(), ec);
+
+        std::ofstream file(full);
+        file << value << '\n';
+        ok_ = ok_ && file.good();
+    }
+
+    void dir(const std::string &path) {
+        std::error_code ec;
+        fs::create_directories(root_ + path, ec);
+        ok_ = ok_ && !ec;
+    }
+
+    bool ok() const {
+        return ok_;
+    }
+
+private:
+    std::string root_;
+    bool ok_ = true;
+};
+
+std::string join_freqs(const std::vector<unsigned long> &freqs) {
+    std::string result;
+    for (unsigned long freq : freqs) {
+        if (!result.empty()) result += ' ';
+        result += std::to_string(freq);
+    }
+    return result;
+}
+
+void populate_cpufreq(TreeWriter &tree, const std::vector<Cluster> &clusters) {
+    for (const auto &cluster : clusters) {
+        const std::string dir = std::string("/sys/devices/system/cpu/cpufreq/") + cluster.policy;
+        tree.node(dir + "/scaling_available_frequencies", join_freqs(cluster.freqs));
+        tree.node(dir + "/cpuinfo_max_freq", std::to_string(cluster.freqs.back()));
+        tree.node(dir + "/cpuinfo_min_freq", std::to_string(cluster.freqs.front()));
+        tree.node(dir + "/scaling_max_freq", std::to_string(cluster.freqs.back()));
+        tree.node(dir + "/scaling_min_freq", std::to_string(cluster.freqs.front()));
+        tree.node(dir + "/scaling_governor", "schedutil");
+    }
+}
+
+void populate_devfreq(TreeWriter &tree, const std::string &dir, const std::vector<unsigned long> &freqs) {
+    tree.node(dir + "/available_frequencies", join_freqs(freqs));
+    tree.node(dir + "/max_freq", std::to_string(freqs.back()));
+    tree.node(dir + "/min_freq", std::to_string(freqs.front()));
+}
+
+void populate_common(TreeWriter &tree) {
+    for (const char *node :
+         {"panic", "panic_on_oops", "panic_on_warn", "softlockup_panic", "perf_cpu_time_max_percent", "sched_schedstats",
+          "sched_autogroup_enabled", "sched_child_runs_first", "sched_nr_migrate", "sched_migration_cost_ns",
+          "sched_min_granularity_ns", "sched_wakeup_granularity_ns", "sched_lib_mask_force", "split_lock_mitigate"}) {
+        tree.node(std::string("/proc/sys/kernel/") + node, "1");
+    }
+    tree.node("/proc/sys/kernel/sched_lib_name", "");
+
+    for (const char *node : {"page-cluster", "stat_interval", "compaction_proactiveness", "vfs_cache_pressure", "drop_caches"}) {
+        tree.node(std::string("/proc/sys/vm/") + node, "0");
+    }
+
+    tree.node("/proc/sys/net/ipv4/tcp_available_congestion_control", "reno cubic bbr");
+    for (const char *node : {"tcp_congestion_control", "tcp_low_latency", "tcp_ecn", "tcp_fastopen", "tcp_sack", "tcp_timestamps"}) {
+        tree.node(std::string("/proc/sys/net/ipv4/") + node, "0");
+    }
+
+    for (const char *dev : {"sda", "sdb", "sdc", "mmcblk0"}) {
+        for (const char *node : {"iostats", "add_random", "read_ahead_kb", "nr_requests"}) {
+            tree.node(std::string("/sys/block/") + dev + "/queue/" + node, "128");
+        }
+    }
+
+    for (int zone = 0; zone < 24; zone++) {
+        tree.node("/sys/class/thermal/thermal_zone" + std::to_string(zone) + "/policy", "power_allocator");
+    }
+
+    tree.node("/sys/module/battery_saver/parameters/enabled", "N");
+    tree.node("/sys/kernel/debug/sched_features", "NEXT_BUDDY TTWU_QUEUE");
+    tree.node("/dev/stune/top-app/schedtune.prefer_idle", "0");
+    tree.node("/dev/stune/top-app/schedtune.boost", "0");
+}
+
+void populate_mediatek(TreeWriter &tree) {
+    populate_cpufreq(tree, {
+        {"policy0", {500000, 774000, 1050000, 1328000, 1600000, 1800000, 2000000}},
+        {"policy4", {650000, 987000, 1400000, 1800000, 2200000, 2600000}},
+        {"policy7", {725000, 1200000, 1750000, 2350000, 2850000, 3050000}},
+    });
+
+    tree.node("/proc/ppm/policy_status", "[0] PPM_POLICY_PTPOD: enabled\n[1] PPM_POLICY_UT: enabled\n"
+                                         "[2] PPM_POLICY_FORCE_LIMIT: enabled\n[3] PPM_POLICY_PWR_THRO: enabled\n"
+                                         "[4] PPM_POLICY_THERMAL: enabled");
+    tree.node("/proc/ppm/policy/hard_userlimit_max_cpu_freq", "-1");
+    tree.node("/proc/ppm/policy/hard_userlimit_min_cpu_freq", "-1");
+
+    tree.node("/proc/cpufreq/cpufreq_cci_mode", "0");
+    tree.node("/proc/cpufreq/cpufreq_power_mode", "0");
+    tree.node("/proc/gpufreq/gpufreq_opp_freq", "0");
+    tree.node("/proc/gpufreq/gpufreq_power_limited", "");
+    tree.node("/proc/gpufreq/gpufreq_opp_dump",
+              "[0] freq = 950000, volt = 80000, vsram_volt = 87500\n[1] freq = 887000, volt = 78125\n"
+              "[2] freq = 700000, volt = 71250\n[3] freq = 530000, volt = 65000\n[4] freq = 390000, volt = 60000");
+    tree.node("/proc/mtk_batoc_throttling/battery_oc_protect_stop", "stop 0");
+
+    tree.node("/sys/kernel/fpsgo/common/force_onoff", "2");
+    tree.node("/sys/devices/platform/boot_dramboost/dramboost/dramboost", "0");
+    tree.node("/sys/devices/system/cpu/eas/enable", "2");
+    tree.node("/sys/module/sspm_v3/holders/ged/parameters/is_GED_KPI_enabled", "1");
+    tree.node("/sys/kernel/ged/hal/custom_boost_gpu_freq", "0");
+    tree.node("/sys/kernel/helio-dvfsrc/dvfsrc_force_vcore_dvfs_opp", "-1");
+    tree.node("/sys/devices/platform/10012000.dvfsrc/helio-dvfsrc/dvfsrc_req_ddr_opp", "-1");
+    tree.node("/sys/devices/platform/13000000.mali/power_policy", "[coarse_demand] always_on");
+    tree.node("/sys/kernel/eara_thermal/enable", "1");
+    populate_devfreq(tree, "/sys/class/devfreq/mtk-dvfsrc-devfreq", {800000000, 1600000000, 2400000000, 3200000000});
+
+    tree.node("/proc/touchpanel/game_switch_enable", "0");
+    tree.node("/proc/touchpanel/oplus_tp_limit_enable", "1");
+    tree.node("/proc/touchpanel/oplus_tp_direction", "0");
+}
+
+void populate_snapdragon(TreeWriter &tree) {
+    populate_cpufreq(tree, {
+        {"policy0", {300000, 691200, 940800, 1190400, 1459200, 1728000, 1958400, 2016000}},
+        {"policy2", {499200, 825600, 1171200, 1497600, 1881600, 2227200, 2476800, 2803200}},
+        {"policy5", {499200, 902400, 1267200, 1651200, 2035200, 2419200, 2803200}},
+        {"policy7", {480000, 1017600, 1555200, 2073600, 2592000, 3187200}},
+    });
+
+    const std::vector<unsigned long> gpu_freqs = {220000000, 310000000, 401000000, 525000000, 660000000, 810000000};
+    populate_devfreq(tree, "/sys/class/kgsl/kgsl-3d0/devfreq", gpu_freqs);
+    tree.node("/sys/class/kgsl/kgsl-3d0/num_pwrlevels", "6");
+    tree.node("/sys/class/kgsl/kgsl-3d0/min_pwrlevel", "5");
+    tree.node("/sys/class/kgsl/kgsl-3d0/max_pwrlevel", "0");
+    tree.node("/sys/class/kgsl/kgsl-3d0/bus_split", "1");
+    tree.node("/sys/class/kgsl/kgsl-3d0/force_clk_on", "0");
+
+    const std::vector<unsigned long> lat_freqs = {300000, 1017600, 1555200, 2092800, 2736000};
+    for (const char *dev : {"soc:qcom,cpu0-cpu-ddr-latfloor", "soc:qcom,cpu4-cpu-ddr-latfloor", "soc:qcom,cpu0-llcc-ddr-lat",
+                            "soc:qcom,cpu6-llcc-ddr-lat", "soc:qcom,cpu0-cpu-l3-lat", "soc:qcom,cpu4-cpu-llcc-lat"}) {
+        populate_devfreq(tree, std::string("/sys/class/devfreq/") + dev, lat_freqs);
+    }
+
+    for (const char *component : {"DDR", "LLCC", "L3"}) {
+        const std::string dir = std::string("/sys/devices/system/cpu/bus_dcvs/") + component;
+        tree.node(dir + "/available_frequencies", join_freqs(lat_freqs));
+        tree.node(dir + "/hw_max_freq", std::to_string(lat_freqs.back()));
+        tree.node(dir + "/hw_min_freq", std::to_string(lat_freqs.front()));
+    }
+
+    tree.node("/proc/touchpanel/game_switch_enable", "0");
+    tree.node("/proc/touchpanel/oplus_tp_limit_enable", "1");
+    tree.node("/proc/touchpanel/oplus_tp_direction", "0");
+}
+
+void populate_exynos(TreeWriter &tree) {
+    populate_cpufreq(tree, {
+        {"policy0", {400000, 672000, 961000, 1248000, 1536000, 1824000, 2002000}},
+        {"policy4", {507000, 858000, 1209000, 1560000, 1911000, 2252000, 2496000}},
+        {"policy8", {520000, 936000, 1352000, 1768000, 2184000, 2600000, 2808000}},
+    });
+
+    tree.node("/sys/kernel/gpu/gpu_available_frequencies", "1209000 1105000 1001000 897000 793000 689000 585000 481000");
+    tree.node("/sys/kernel/gpu/gpu_max_clock", "1209000");
+    tree.node("/sys/kernel/gpu/gpu_min_clock", "481000");
+    tree.node("/sys/devices/platform/18500000.mali/power_policy", "[adaptive] coarse_demand always_on");
+
+    populate_devfreq(tree, "/sys/class/devfreq/17000010.devfreq_mif", {421000, 845000, 1352000, 2028000, 2730000, 3172000});
+    tree.dir("/sys/class/devfreq/17000020.devfreq_int");
+}
+
+} // namespace
+
+bool populate_fake_sysfs(const std::string &root, SocVendor soc) {
+    TreeWriter tree(root);
+    populate_common(tree);
+
+    switch (soc) {
+        case SocVendor::MediaTek: populate_mediatek(tree); break;
+        case SocVendor::Snapdragon: populate_snapdragon(tree); break;
+        case SocVendor::Exynos: populate_exynos(tree); break;
+        default: return false;
+    }
+
+    return tree.ok();
+}
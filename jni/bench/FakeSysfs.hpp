@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <ProfileEngine.hpp>
+
+/**
+ * @brief Populates a directory with a synthetic sysfs/procfs tree modelling a SoC.
+ *
+ * Only the nodes consulted by the profile engine are created, with plausible
+ * frequency tables and default values.
+ *
+ * @param root Directory to populate, created if missing.
+ * @param soc SoC layout to model, MediaTek, Snapdragon or Exynos.
+ * @return true on success, false if the tree cannot be created.
+ */
+bool populate_fake_sysfs(const std::string &root, SocVendor soc);
@@ -34,6 +34,17 @@
 #define DEFAULT_CPU_GOV CONFIG_DIR "/default_cpu_gov"
 #define ENCORE_GAMELIST CONFIG_DIR "/gamelist.json"
 #define SYSTEM_STATUS_FILE CONFIG_DIR "/system_status"
+#define SOC_RECOGNITION_FILE CONFIG_DIR "/soc_recognition"
+#define HARDWARE_MANIFEST CONFIG_DIR "/hardware_manifest.json"
+#define FREQ_TABLE_CACHE CONFIG_DIR "/freq_tables.json"
+#define PRISTINE_SNAPSHOT CONFIG_DIR "/pristine_snapshot"
+#define NODES_RESTORED_FILE CONFIG_DIR "/.nodes_restored"
+#define PROFILE_TWEAKS_FILE CONFIG_DIR "/profile_tweaks.json"
+#define PROFILE_TWEAKS_BLOB CONFIG_DIR "/profile_tweaks.bin"
+#define BINDER_CODE_CACHE CONFIG_DIR "/binder_codes"
+#define GAME_DETECTION_CACHE CONFIG_DIR "/detected_games"
+
+#define PACKAGES_LIST "/data/system/packages.list"
 
 #define MODULE_PROP MODPATH "/module.prop"
 #define MODULE_UPDATE MODPATH "/update"
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2024-2026 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+/**
+ * @class MpscQueue
+ * @brief Unbounded lock-free queue with many producers and a single consumer.
+ *
+ * push() is a single atomic exchange and never waits on the consumer or other producers.
+ * A value pushed while pop() runs may only become visible to the next pop(), so producers
+ * should wake the consumer after pushing.
+ *
+ * @tparam T Default constructible, movable value type.
+ */
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue()
+        : head_(new Node())
+        , tail_(head_.load(std::memory_order_relaxed)) {
+    }
+
+    ~MpscQueue() {
+        T discard;
+        while (pop(discard)) {
+        }
+        delete tail_;
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    /**
+     * @brief Appends a value, safe to call from any thread.
+     */
+    void push(T value) {
+        Node *node = new Node();
+        node->value = std::move(value);
+
+        Node *prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * @brief Takes the oldest value, must only be called from the consumer thread.
+     *
+     * @param value Receives the value.
+     * @return true if a value was taken, false if the queue is empty.
+     */
+    bool pop(T &value) {
+        Node *next = tail_->next.load(std::memory_order_acquire);
+        if (!next) return false;
+
+        // The consumed node becomes the new stub
+        value = std::move(next->value);
+        delete tail_;
+        tail_ = next;
+        return true;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node *> next{nullptr};
+        T value{};
+    };
+
+    std::atomic<Node *> head_; /// Last pushed node, shared by producers
+    Node *tail_;               /// Stub node preceding the oldest value, consumer only
+};
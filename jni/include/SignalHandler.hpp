@@ -41,6 +41,14 @@ inline std::vector<SignalCallback> sigusr1_callbacks;
 /// Registered callbacks for SIGUSR2.
 inline std::vector<SignalCallback> sigusr2_callbacks;
 
+/// Callback type for work that has to happen before the daemon exits.
+using CleanupCallback = std::function<void()>;
+
+/// Registered cleanup callbacks.
+inline std::vector<CleanupCallback> cleanup_callbacks;
+/// Ensures cleanup runs once, whichever exit path gets there first.
+inline std::sig_atomic_t cleaned_up = 0;
+
 /**
  * @brief Register a callback to be invoked when SIGHUP is received.
  *
@@ -70,6 +78,17 @@ inline void on_sigusr2(SignalCallback cb) {
     sigusr2_callbacks.push_back(std::move(cb));
 }
 
+/**
+ * @brief Register a callback to be invoked before the daemon exits.
+ *
+ * @param cb Callable with signature void().
+ * @note Callbacks also run from the SIGTERM/SIGINT handler and must be async-signal-safe.
+ *       Register them before any exit path can be taken.
+ */
+inline void on_cleanup(CleanupCallback cb) {
+    cleanup_callbacks.push_back(std::move(cb));
+}
+
 // ---------------------------------------------------------------------------
 // Async-signal-safe helpers
 // ---------------------------------------------------------------------------
@@ -106,6 +125,18 @@ inline void safe_log_signal(int sig) {
     safe_write("\n");
 }
 
+/**
+ * @brief Run every registered cleanup callback, only the first call has an effect.
+ */
+inline void run_cleanup_callbacks() {
+    if (cleaned_up) return;
+    cleaned_up = 1;
+
+    for (const auto &cb : cleanup_callbacks) {
+        if (cb) cb();
+    }
+}
+
 // ---------------------------------------------------------------------------
 // Signal handlers
 // ---------------------------------------------------------------------------
@@ -141,6 +172,7 @@ inline void exit_signal_handler(int sig) {
     handling_signal = 1;
 
     safe_log_signal(sig);
+    run_cleanup_callbacks();
     fsync(STDERR_FILENO);
     EncoreLog::flush();
 
@@ -211,9 +243,10 @@ inline void setup_signal_handlers() {
 // ---------------------------------------------------------------------------
 
 /**
- * @brief Flush all pending log messages before exit.
+ * @brief Run cleanup callbacks and flush all pending log messages before exit.
  */
 inline void cleanup_before_exit() {
+    run_cleanup_callbacks();
     EncoreLog::flush();
 }
 
@@ -153,7 +153,6 @@ extract "$ZIPFILE" 'uninstall.sh' "$MODPATH"
 extract "$ZIPFILE" 'action.sh' "$MODPATH"
 extract "$ZIPFILE" 'cleanup.sh' "$MODPATH"
 extract "$ZIPFILE" 'binder_resolver.apk' "$MODPATH"
-extract "$ZIPFILE" 'system/bin/encore_profiler' "$MODPATH"
 extract "$ZIPFILE" 'system/bin/encore_utility' "$MODPATH"
 cp "$MODPATH/module.prop" "$MODPATH/module.prop.orig"
 
@@ -184,7 +183,6 @@ if [ "$KSU" = "true" ] || [ "$APATCH" = "true" ]; then
 		[ -d "$dir" ] && {
 			ui_print "- Creating symlink in $dir"
 			ln -sf "$BIN_PATH/encored" "$dir/encored"
-			ln -sf "$BIN_PATH/encore_profiler" "$dir/encore_profiler"
 			ln -sf "$BIN_PATH/encore_utility" "$dir/encore_utility"
 		}
 	done
@@ -201,10 +199,16 @@ unzip -o "$ZIPFILE" "webroot/*" -d "$MODPATH" -x "*.sha256" >&2
 # Set configs
 ui_print "- Encore Tweaks configuration setup"
 make_dir "$MODULE_CONFIG"
-unzip -o "$ZIPFILE" "config/*" -d "$MODULE_CONFIG" -x "*.sha256" >&2
+# Keep declared profile tweaks across updates
+KEEP_TWEAKS=""
+[ -f "$MODULE_CONFIG/profile_tweaks.json" ] && KEEP_TWEAKS="config/profile_tweaks.json"
+unzip -o "$ZIPFILE" "config/*" -d "$MODULE_CONFIG" -x "*.sha256" $KEEP_TWEAKS >&2
 mv "$MODULE_CONFIG/config/"* "$MODULE_CONFIG/"
 rm -rf "$MODULE_CONFIG/config"
 
+# Let the new daemon rediscover hardware capabilities and binder transaction codes
+rm -f "$MODULE_CONFIG/hardware_manifest.json" "$MODULE_CONFIG/freq_tables.json" "$MODULE_CONFIG/binder_codes"
+
 # Permission settings
 ui_print "- Permission setup"
 set_perm_recursive "$MODPATH/system/bin" 0 0 0755 0755
@@ -243,6 +247,9 @@ soc_recognition_extra
 
 echo $SOC >"$MODULE_CONFIG/soc_recognition"
 
+# Compile declared profile tweaks
+"$MODPATH/system/bin/encored" compile_tweaks || ui_print "! Declared profile tweaks are invalid, skipping them"
+
 # Easter Egg
 case "$((RANDOM % 9 + 1))" in
 1) ui_print "- Wooly's Fairy Tale" ;;